@@ -0,0 +1,78 @@
+// This module implements arena.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include "arena.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+ArenaBlock* arena_add_block(Arena* arena, size_t minimum_size);
+
+
+// ============================== Arena Struct ============================= //
+Arena* arena_new(size_t size_hint)
+{
+    Arena* arena = calloc(1, sizeof(Arena));
+    if (!arena) { return NULL; }
+    arena->block_size = size_hint > ARENA_MIN_BLOCK_SIZE ? size_hint : ARENA_MIN_BLOCK_SIZE;
+    return arena;
+}
+
+void arena_free(Arena* arena)
+{
+    if (!arena) { return; }
+
+    // free every block, then the arena itself
+    ArenaBlock* block = arena->blocks;
+    while (block)
+    {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+void* arena_alloc(Arena* arena, size_t size)
+{
+    if (!arena) { return NULL; }
+
+    // round the size up, so the next allocation stays aligned
+    size = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+    // if the newest block doesn't have room, add another
+    ArenaBlock* block = arena->blocks;
+    if (!block || block->size - block->used < size)
+    {
+        block = arena_add_block(arena, size);
+        if (!block) { return NULL; }
+    }
+
+    // blocks are zeroed when they're allocated, and never reused, so the
+    // memory is already zeroed
+    void* result = block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Allocates a new block that can hold at least 'minimum_size' bytes and makes
+// it the arena's newest block. Returns NULL on failure.
+ArenaBlock* arena_add_block(Arena* arena, size_t minimum_size)
+{
+    size_t size = arena->block_size;
+    if (size < minimum_size) { size = minimum_size; }
+
+    ArenaBlock* block = calloc(1, sizeof(ArenaBlock) + size);
+    if (!block) { return NULL; }
+    block->size = size;
+    block->used = 0;
+
+    // chain it in front of the others, and make the next block twice as big
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->block_size = size * 2;
+    return block;
+}
@@ -0,0 +1,50 @@
+// This header file defines the Arena: a region allocator that hands out memory
+// from a few large blocks. Allocations can't be freed one at a time - instead,
+// everything allocated from an arena is released at once when the arena is
+// freed. Each loaded TaskList owns one, so loading and freeing a list takes a
+// handful of heap allocations rather than several per task.
+//
+//      Connor Shugg
+
+#ifndef ARENA_H
+#define ARENA_H
+
+// Module inclusions
+#include <stddef.h>
+
+// ========================= Constants and Macros ========================== //
+#define ARENA_MIN_BLOCK_SIZE 4096       // smallest block an arena allocates
+#define ARENA_ALIGNMENT 16              // every allocation is aligned to this
+
+
+// ============================== Arena Struct ============================= //
+// A single block of memory. Allocations are carved off of 'data' in order.
+typedef struct _ArenaBlock
+{
+    struct _ArenaBlock* next;       // the block allocated before this one
+    size_t size;                    // number of bytes in 'data'
+    size_t used;                    // number of bytes handed out
+    size_t padding;                 // keeps 'data' aligned to ARENA_ALIGNMENT
+    char data[];
+} ArenaBlock;
+
+// The 'Arena' struct holds the chain of blocks. When the newest block fills
+// up, a new one (at least twice as big) is allocated.
+typedef struct _Arena
+{
+    ArenaBlock* blocks;             // newest block (the rest are chained)
+    size_t block_size;              // size of the next block to allocate
+} Arena;
+
+// Constructor: dynamically allocates a new Arena. 'size_hint' is the number of
+// bytes the caller expects to allocate from it - if it's right, everything
+// fits in the first block. If allocation fails, NULL is returned.
+Arena* arena_new(size_t size_hint);
+
+// Destructor: frees the arena and everything that was allocated from it.
+void arena_free(Arena* arena);
+
+// Allocates 'size' zeroed bytes from the arena. Returns NULL on failure.
+void* arena_alloc(Arena* arena, size_t size);
+
+#endif
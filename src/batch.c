@@ -0,0 +1,51 @@
+// This module implements batch.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <string.h>
+#include "batch.h"
+
+
+// ============================ Batch Functions ============================ //
+int batch_split_line(char* line, char** args, int max_args)
+{
+    int argc = 0;
+    char* read = line;
+    while (1)
+    {
+        // skip the whitespace between arguments
+        while (*read == ' ' || *read == '\t' || *read == '\r' || *read == '\n')
+        { read++; }
+        if (*read == '\0' || *read == '#') { break; }
+        if (argc == max_args) { return -1; }
+
+        // copy the argument over itself, dropping its quotes and escapes
+        char* write = read;
+        args[argc++] = write;
+        char quote = '\0';
+        while (*read != '\0')
+        {
+            char c = *read++;
+            if (quote == '\'' && c == '\'') { quote = '\0'; }
+            else if (quote == '\'') { *write++ = c; }
+            else if (c == '\\' && *read != '\0' && *read != '\n')
+            { *write++ = *read++; }
+            else if (quote == '"' && c == '"') { quote = '\0'; }
+            else if (!quote && (c == '\'' || c == '"')) { quote = c; }
+            else if (!quote && (c == ' ' || c == '\t' || c == '\r' || c == '\n'))
+            { break; }
+            else { *write++ = c; }
+        }
+        if (quote) { return -1; }
+        *write = '\0';
+    }
+
+    // the line may start with "ttydo", just like it would on the command line
+    if (argc > 0 && !strcmp(args[0], BATCH_COMMAND_NAME))
+    {
+        memmove(args, args + 1, (argc - 1) * sizeof(char*));
+        argc--;
+    }
+    return argc;
+}
@@ -0,0 +1,26 @@
+// This header file defines how the lines of a batch file (see the 'batch'
+// command) are split into arguments. Each line is written just like it would
+// be on the command line, so it's split the way a shell would split it.
+//
+//      Connor Shugg
+
+#ifndef BATCH_H
+#define BATCH_H
+
+// ========================= Constants and Macros ========================== //
+#define BATCH_MAX_ARGS 64                   // max arguments in a single line
+#define BATCH_COMMAND_NAME "ttydo"          // optional first argument
+
+
+// ============================ Batch Functions ============================ //
+// Splits a line into arguments, in place, the way a shell would: arguments
+// are separated by whitespace, and may be wrapped in single quotes (taken
+// as-is) or double quotes (in which a backslash escapes the next character).
+// Outside of quotes, a backslash escapes the next character, and a '#' at
+// the start of an argument begins a comment. If the first argument is
+// "ttydo", it's dropped. Up to 'max_args' pointers are saved to 'args'.
+// Returns the number of arguments (0 for a blank line or a comment), or -1 if
+// a quote isn't closed or there are too many arguments.
+int batch_split_line(char* line, char** args, int max_args);
+
+#endif
@@ -8,17 +8,18 @@
 #include <string.h>
 #include "utils.h"
 #include "command.h"
+#include "daemon.h"
 #include "handlers/handlers.h"
 #include "../tasklist.h"
 
 // ======================= Globals/Macros/Prototypes ======================= //
 // Command globals
-int NUM_COMMANDS = 3;       // number of commands in the array
+int NUM_COMMANDS = 5;       // number of commands in the array
 Command** commands = NULL;  // global array of commands
 // Task list globals
 int tasklist_array_capacity = 8; // initial cap of our global tasklist array
 int tasklist_array_length = 0;   // number of task lists in the array
-TaskList** tasklists = NULL;     // global array of task lists
+TaskListHandle* tasklists = NULL; // global array of task list handles
 // Function prototypes
 void init_commands();
 int execute_command(int argc, char** args);
@@ -28,6 +29,12 @@ int execute_command(int argc, char** args);
 // parse them into a command. If a matching command is found, it's executed.
 int main(int argc, char** argv)
 {
+    // if a daemon is running, it already has our lists loaded, so we'll hand
+    // the command over to it. Otherwise, we'll run it ourselves
+    int status = 0;
+    if (!daemon_forward(argc - 1, argv + 1, &status))
+    { exit(status); }
+
     // initialize the command array and our global task list
     init_commands();
     tasklist_array_init();
@@ -72,6 +79,14 @@ void init_commands()
     // task command
     commands[2] = init_command_task();
     if (!commands[2]) { fatality(1, fatality_message); }
+
+    // batch command
+    commands[3] = init_command_batch();
+    if (!commands[3]) { fatality(1, fatality_message); }
+
+    // serve command
+    commands[4] = init_command_serve();
+    if (!commands[4]) { fatality(1, fatality_message); }
 }
 
 // Searches the command list for a command with the name given by the
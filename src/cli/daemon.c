@@ -0,0 +1,532 @@
+// A module that implements daemon.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "daemon.h"
+#include "utils.h"
+#include "handlers/handlers.h"
+#include "pager.h"
+#include "../scribe.h"
+#include "../visual/terminal.h"
+#ifdef __linux__
+#include <stdio_ext.h>
+#endif
+
+// =============== Constants and Helper Function Prototypes ================ //
+#define DAEMON_FD_COUNT 3   // stdin, stdout, and stderr are sent to the daemon
+
+// Server state
+char* daemon_socket_path = NULL;        // path of the socket being served
+int daemon_listen_fd = -1;              // the socket clients connect to
+int daemon_saved_fds[DAEMON_FD_COUNT] = {-1, -1, -1}; // our own stdio
+int daemon_saved_cwd = -1;              // our own working directory
+volatile sig_atomic_t daemon_stopping = 0;
+int daemon_handing_back = 0;            // set if the client has to run it
+struct sigaction daemon_saved_actions[2]; // SIGINT and SIGTERM's old handlers
+// Client state
+pid_t daemon_pid = 0;                   // pid of the daemon we're talking to
+
+char* make_daemon_socket_path();
+int daemon_connect(char* path);
+int daemon_write_all(int fd, void* data, size_t length);
+int daemon_read_all(int fd, void* data, size_t length);
+void daemon_forward_resize(int signal_number);
+void daemon_handle_client(int fd);
+int daemon_receive_header(int fd, DaemonRequest* header, int* fds);
+int daemon_run(int argc, char** args, char* cwd, int* fds);
+void daemon_recover();
+void daemon_redirect(int* fds);
+void daemon_on_signal(int signal_number);
+void daemon_clean_up();
+
+
+// =========================== Client Functions ============================ //
+int daemon_forward(int argc, char** args, int* status)
+{
+    // the request holds our working directory (so relative paths mean the
+    // same thing to the daemon) and our arguments. If it'd be too big, we'll
+    // run the command ourselves
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, PATH_MAX)) { cwd[0] = '\0'; }
+    size_t length = strlen(cwd) + 1;
+    for (int i = 0; i < argc; i++) { length += strlen(args[i]) + 1; }
+    if (argc > DAEMON_MAX_ARGS || length > DAEMON_MAX_REQUEST_LENGTH)
+    { return 1; }
+
+    // connect to the daemon (if there isn't one, there's nothing to do)
+    char* path = make_daemon_socket_path();
+    if (!path) { return 1; }
+    int fd = daemon_connect(path);
+    free(path);
+    if (fd < 0) { return 1; }
+
+    char* text = malloc(length);
+    if (!text)
+    {
+        close(fd);
+        return 1;
+    }
+    size_t position = 0;
+    memcpy(text, cwd, strlen(cwd) + 1);
+    position += strlen(cwd) + 1;
+    for (int i = 0; i < argc; i++)
+    {
+        memcpy(text + position, args[i], strlen(args[i]) + 1);
+        position += strlen(args[i]) + 1;
+    }
+
+    // send the header, along with our stdin, stdout, and stderr
+    DaemonRequest header = {DAEMON_PROTOCOL_VERSION, argc, length};
+    int fds[DAEMON_FD_COUNT] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    char control[CMSG_SPACE(sizeof(fds))];
+    memset(control, 0, sizeof(control));
+    struct iovec vector = {&header, sizeof(DaemonRequest)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    // the daemon doesn't run anything until it has the whole request, so if
+    // it can't all be sent, the command can still be run directly
+    int sent = sendmsg(fd, &message, MSG_NOSIGNAL) == sizeof(DaemonRequest) &&
+               !daemon_write_all(fd, text, length);
+    free(text);
+    if (!sent)
+    {
+        close(fd);
+        return 1;
+    }
+
+    // while the daemon is running the command, pass along any resizes of our
+    // terminal (the daemon isn't attached to it, so it won't hear about them)
+    struct sigaction saved_action;
+#ifdef SO_PEERCRED
+    struct ucred credentials;
+    socklen_t credentials_length = sizeof(struct ucred);
+    if (!getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials,
+                    &credentials_length))
+    { daemon_pid = credentials.pid; }
+#endif
+    struct sigaction action;
+    memset(&action, 0, sizeof(struct sigaction));
+    action.sa_handler = daemon_forward_resize;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGWINCH, &action, &saved_action);
+
+    // wait for the command's exit status. If the daemon goes away before
+    // sending it, the command may or may not have run, so it isn't retried
+    int32_t reply = 1;
+    if (daemon_read_all(fd, &reply, sizeof(int32_t)))
+    { eprintf("Lost the connection to the ttydo daemon.\n"); }
+    sigaction(SIGWINCH, &saved_action, NULL);
+    close(fd);
+
+    // the daemon hands back commands that would have to wait on the user
+    // (without having run any of it), so we'll run those ourselves
+    if (reply == DAEMON_HAND_BACK_STATUS) { return 1; }
+    *status = reply;
+    return 0;
+}
+
+
+// =========================== Server Functions ============================ //
+int daemon_serve()
+{
+    if (daemon_is_serving()) { return 1; }
+
+    // only one daemon can serve each ttydo directory. If something's
+    // listening on the socket already, we'll leave it be. Otherwise, the
+    // socket was left behind by a daemon that didn't exit cleanly
+    daemon_socket_path = make_daemon_socket_path();
+    if (!daemon_socket_path) { return 1; }
+    int existing = daemon_connect(daemon_socket_path);
+    if (existing >= 0)
+    {
+        close(existing);
+        eprintf("A ttydo daemon is already serving %s.\n", daemon_socket_path);
+        daemon_clean_up();
+        return 1;
+    }
+    unlink(daemon_socket_path);
+
+    // create the socket (which only we can connect to) and start listening
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s",
+             daemon_socket_path);
+    daemon_listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t saved_mask = umask(0177);
+    int bound = daemon_listen_fd >= 0 &&
+                !bind(daemon_listen_fd, (struct sockaddr*) &address,
+                      sizeof(struct sockaddr_un));
+    umask(saved_mask);
+    if (!bound || listen(daemon_listen_fd, DAEMON_BACKLOG))
+    {
+        eprintf("Couldn't listen on %s.\n", daemon_socket_path);
+        daemon_clean_up();
+        return 1;
+    }
+
+    // keep copies of our own stdio and working directory (each request
+    // swaps in its client's), and make sure the socket is removed however
+    // we exit (even through 'fatality')
+    for (int i = 0; i < DAEMON_FD_COUNT; i++)
+    { daemon_saved_fds[i] = fcntl(i, F_DUPFD, DAEMON_FD_COUNT); }
+    daemon_saved_cwd = open(".", O_RDONLY | O_DIRECTORY);
+    atexit(daemon_clean_up);
+
+    // SIGINT and SIGTERM stop the daemon (SA_RESTART is left off, so they
+    // interrupt the wait for the next client). Clients that hang up early
+    // mustn't take the daemon down with SIGPIPE
+    struct sigaction action;
+    memset(&action, 0, sizeof(struct sigaction));
+    action.sa_handler = daemon_on_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &daemon_saved_actions[0]);
+    sigaction(SIGTERM, &action, &daemon_saved_actions[1]);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Serving task lists on %s. (Run 'ttydo serve stop' to stop.)\n",
+           daemon_socket_path);
+    fflush(stdout);
+
+    // answer one client at a time, until we're asked to stop
+    daemon_stopping = 0;
+    while (!daemon_stopping)
+    {
+        int client = accept(daemon_listen_fd, NULL, NULL);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) { continue; }
+            eprintf("Couldn't accept a connection on %s.\n",
+                    daemon_socket_path);
+            break;
+        }
+        daemon_handle_client(client);
+        close(client);
+    }
+
+    sigaction(SIGINT, &daemon_saved_actions[0], NULL);
+    sigaction(SIGTERM, &daemon_saved_actions[1], NULL);
+    printf("The ttydo daemon has stopped.\n");
+    daemon_clean_up();
+    return 0;
+}
+
+int daemon_is_serving()
+{ return daemon_listen_fd >= 0; }
+
+void daemon_stop()
+{ daemon_stopping = 1; }
+
+void daemon_hand_back()
+{ daemon_handing_back = 1; }
+
+
+// =========================== Helper Functions ============================ //
+// Builds the path of the daemon's socket. The returned string is dynamically
+// allocated. Returns NULL on failure (including if the path is too long to
+// be a socket's address).
+char* make_daemon_socket_path()
+{
+    char* home = get_home_directory();
+    if (!home) { return NULL; }
+    int length = strlen(home) + strlen(DAEMON_SOCKET_NAME) + 2;
+    if (length > (int) sizeof(((struct sockaddr_un*) 0)->sun_path))
+    { return NULL; }
+
+    char* result = malloc(length);
+    if (!result) { return NULL; }
+    snprintf(result, length, "%s/%s", home, DAEMON_SOCKET_NAME);
+    return result;
+}
+
+// Connects to the socket at the given path. Returns the connected socket, or
+// -1 if nothing is listening there.
+int daemon_connect(char* path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { return -1; }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    snprintf(address.sun_path, sizeof(address.sun_path), "%s", path);
+    if (connect(fd, (struct sockaddr*) &address, sizeof(struct sockaddr_un)))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Writes all 'length' bytes of the given data to the socket. Returns 0 on
+// success and a non-zero value on failure.
+int daemon_write_all(int fd, void* data, size_t length)
+{
+    size_t written = 0;
+    while (written < length)
+    {
+        ssize_t result = send(fd, (char*) data + written, length - written,
+                              MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) { continue; }
+        if (result <= 0) { return 1; }
+        written += result;
+    }
+    return 0;
+}
+
+// Reads exactly 'length' bytes from the socket into the given buffer.
+// Returns 0 on success and a non-zero value on failure (including if the
+// other end hangs up first, or the read times out).
+int daemon_read_all(int fd, void* data, size_t length)
+{
+    size_t total = 0;
+    while (total < length)
+    {
+        ssize_t result = read(fd, (char*) data + total, length - total);
+        if (result < 0 && errno == EINTR) { continue; }
+        if (result <= 0) { return 1; }
+        total += result;
+    }
+    return 0;
+}
+
+// Signal handler for SIGWINCH, while a client is waiting on the daemon: the
+// daemon is sent the signal too, so it can redraw (for example, the pager).
+void daemon_forward_resize(int signal_number)
+{
+    if (daemon_pid > 0) { kill(daemon_pid, SIGWINCH); }
+}
+
+// Reads a single request from a client, runs it, and sends back its exit
+// status. Malformed requests are dropped without running anything.
+void daemon_handle_client(int fd)
+{
+#ifdef SO_PEERCRED
+    // only the user running the daemon may use it
+    struct ucred credentials;
+    socklen_t credentials_length = sizeof(struct ucred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials,
+                   &credentials_length) || credentials.uid != getuid())
+    { return; }
+#endif
+
+    // a client that never finishes its request mustn't hold up everyone
+    // waiting behind it
+    struct timeval timeout = {DAEMON_READ_TIMEOUT, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(struct timeval));
+
+    DaemonRequest header;
+    int fds[DAEMON_FD_COUNT];
+    if (daemon_receive_header(fd, &header, fds)) { return; }
+
+    // read the text, and split it up into the working directory and each
+    // argument. There has to be exactly one of each
+    char* text = NULL;
+    char* args[DAEMON_MAX_ARGS + 1];
+    int count = 0;
+    if (header.version == DAEMON_PROTOCOL_VERSION &&
+        header.argc <= DAEMON_MAX_ARGS && header.length > 0 &&
+        header.length <= DAEMON_MAX_REQUEST_LENGTH)
+    { text = malloc(header.length); }
+    if (text && !daemon_read_all(fd, text, header.length) &&
+        text[header.length - 1] == '\0')
+    {
+        for (uint32_t position = 0; position < header.length &&
+             count <= (int) header.argc; count++)
+        {
+            args[count] = text + position;
+            position += strlen(text + position) + 1;
+        }
+    }
+
+    // run it, then send back its exit status
+    if (text && count == (int) header.argc + 1)
+    {
+        int32_t status = daemon_run(header.argc, args + 1, args[0], fds);
+        daemon_write_all(fd, &status, sizeof(int32_t));
+    }
+    free(text);
+    for (int i = 0; i < DAEMON_FD_COUNT; i++) { close(fds[i]); }
+}
+
+// Receives a request's header, along with the client's stdin, stdout, and
+// stderr (which are saved to 'fds'). Returns 0 on success and a non-zero
+// value on failure (in which case no descriptors are left open).
+int daemon_receive_header(int fd, DaemonRequest* header, int* fds)
+{
+    char control[CMSG_SPACE(sizeof(int) * DAEMON_FD_COUNT)];
+    struct iovec vector = {header, sizeof(DaemonRequest)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    ssize_t received = recvmsg(fd, &message, 0);
+
+    // pick out the descriptors (closing any that came in the wrong shape)
+    int fd_count = 0;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+         received > 0 && cmsg; cmsg = CMSG_NXTHDR(&message, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+        { continue; }
+        int count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (int i = 0; i < count; i++)
+        {
+            int received_fd;
+            memcpy(&received_fd, CMSG_DATA(cmsg) + i * sizeof(int),
+                   sizeof(int));
+            if (fd_count < DAEMON_FD_COUNT) { fds[fd_count++] = received_fd; }
+            else { close(received_fd); }
+        }
+    }
+
+    // the rest of the header may arrive separately
+    int failed = received <= 0 || fd_count != DAEMON_FD_COUNT ||
+                 (message.msg_flags & MSG_CTRUNC) ||
+                 daemon_read_all(fd, (char*) header + received,
+                                 sizeof(DaemonRequest) - received);
+    if (failed)
+    {
+        for (int i = 0; i < fd_count; i++) { close(fds[i]); }
+        return 1;
+    }
+    return 0;
+}
+
+// Runs a client's command, with its stdio and working directory swapped in
+// for ours. Returns the exit status ttydo would have exited with, had the
+// command been run directly (or DAEMON_HAND_BACK_STATUS, if the client has
+// to run it itself).
+int daemon_run(int argc, char** args, char* cwd, int* fds)
+{
+    daemon_redirect(fds);
+    if (cwd[0] != '\0' && chdir(cwd))
+    { wprintf("Couldn't change to directory %s.\n", cwd); }
+
+    // a fatal error in the command mustn't take the daemon (and everyone
+    // else's commands) down with it, so 'fatality' jumps back here instead,
+    // and the client is sent an error status
+    jmp_buf recovery;
+    volatile int status = 0;
+    int fatal = 0;
+    daemon_handing_back = 0;
+    if (setjmp(recovery) == 0)
+    {
+        fatality_recover_at(&recovery);
+
+        // pick up anything that changed since the last command
+        if (tasklist_array_refresh())
+        { fatality(1, "Failed to reload the task lists."); }
+
+        // run the command, just like 'main' would have
+        if (argc == 0) { print_intro(); }
+        else if (execute_command(argc, args) < 0)
+        {
+            fprintf(stderr, "Fatal ");
+            eprintf("Command not found. (Try 'ttydo help')\n");
+            status = 1;
+        }
+
+        // bring the manifest up to date (every change was already saved)
+        tasklist_array_sync();
+    }
+    else
+    {
+        fatal = 1;
+        status = 1;
+    }
+    fatality_recover_at(NULL);
+    if (fatal) { daemon_recover(); }
+
+    // put our own stdio and working directory back
+    daemon_redirect(daemon_saved_fds);
+    if (daemon_saved_cwd >= 0 && fchdir(daemon_saved_cwd))
+    { eprintf("Couldn't change back to the daemon's directory.\n"); }
+    return daemon_handing_back ? DAEMON_HAND_BACK_STATUS : status;
+}
+
+// Puts the daemon back in working order after a command hits a fatal error.
+// Whatever the command left switched on or off is reset, and every list is
+// dropped (the ones in memory may have been left half-changed), to be
+// reloaded from disk by the next command.
+void daemon_recover()
+{
+    defer_task_list_saves(0);
+    pager_set_enabled(1);
+    terminal_watch_resize(0);
+    if (tasklists) { tasklist_array_free(); }
+    tasklist_array_length = 0;
+}
+
+// Points stdin, stdout, and stderr at the given descriptors. Anything still
+// buffered for the old ones is flushed (or, for stdin, thrown away) first.
+void daemon_redirect(int* fds)
+{
+    fflush(stdout);
+    fflush(stderr);
+    clearerr(stdin);
+    clearerr(stdout);
+    clearerr(stderr);
+#ifdef __linux__
+    __fpurge(stdin);
+#endif
+    for (int i = 0; i < DAEMON_FD_COUNT; i++)
+    {
+        if (fds[i] >= 0) { dup2(fds[i], i); }
+    }
+
+    // the terminal (if there is one) may be a different size now
+    terminal_forget_size();
+}
+
+// Signal handler for SIGINT and SIGTERM: the daemon stops.
+void daemon_on_signal(int signal_number)
+{ daemon_stopping = 1; }
+
+// Closes the daemon's socket (and removes it), and everything else it kept
+// open. Safe to call more than once.
+void daemon_clean_up()
+{
+    if (daemon_listen_fd >= 0)
+    {
+        close(daemon_listen_fd);
+        unlink(daemon_socket_path);
+        daemon_listen_fd = -1;
+    }
+    for (int i = 0; i < DAEMON_FD_COUNT; i++)
+    {
+        if (daemon_saved_fds[i] >= 0) { close(daemon_saved_fds[i]); }
+        daemon_saved_fds[i] = -1;
+    }
+    if (daemon_saved_cwd >= 0) { close(daemon_saved_cwd); }
+    daemon_saved_cwd = -1;
+    free(daemon_socket_path);
+    daemon_socket_path = NULL;
+}
@@ -0,0 +1,84 @@
+// This header file defines ttydo's daemon: a long-running ttydo process
+// (started with 'ttydo serve') that keeps every task list it has loaded in
+// memory, and runs commands on behalf of other ttydo processes. Each ttydo
+// invocation first tries to connect to the daemon's socket (in ~/.ttydo). If
+// it can, it hands over its arguments (and its stdin, stdout, and stderr, so
+// the daemon's output goes straight to the right terminal) and exits with
+// the status the daemon sends back. If no daemon is running, the command is
+// run directly, as usual.
+//
+// Consistency:
+//  - The daemon runs one command at a time, in the order they arrive. Each
+//    one sees the changes made by every command before it, and no two are
+//    ever interleaved.
+//  - Every change is written to disk (as usual) before the client is sent
+//    its reply, so nothing that's been reported as done is lost if the
+//    daemon stops.
+//  - Before each command, the daemon checks whether any list has changed on
+//    disk since its last command (because ttydo was run directly, or a file
+//    was edited by hand). If one has, its lists are reloaded first.
+//  - Commands that would wait on the user (the pager, or a batch read from
+//    stdin, a pipe, or a terminal) would hold up everyone else, so they're
+//    handed back to the client to run itself, like it would if no daemon
+//    were running.
+//  - A command that hits a fatal error only fails itself: the daemon sends
+//    back an error status, reloads its lists from disk, and carries on.
+//
+//      Connor Shugg
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+// Module inclusions
+#include <inttypes.h>
+
+// ========================= Constants and Macros ========================== //
+#define DAEMON_SOCKET_NAME "daemon.sock"    // name of the socket in ~/.ttydo
+#define DAEMON_PROTOCOL_VERSION 1           // version sent with each request
+#define DAEMON_MAX_ARGS 256                 // most arguments in a request
+#define DAEMON_MAX_REQUEST_LENGTH 1048576   // most bytes of text in a request
+#define DAEMON_READ_TIMEOUT 5               // seconds to wait for a request
+#define DAEMON_BACKLOG 64                   // clients that can wait in line
+#define DAEMON_HAND_BACK_STATUS -1          // sent back if the client has to
+                                            // run the command itself
+
+// Every request starts with this header. It's followed by 'length' bytes of
+// text: the client's working directory, then each of its arguments, each one
+// ending in a '\0'. The client's stdin, stdout, and stderr are sent along
+// with the header. The daemon replies with the command's exit status, as a
+// single int32_t.
+typedef struct _DaemonRequest
+{
+    uint32_t version;   // DAEMON_PROTOCOL_VERSION
+    uint32_t argc;      // number of arguments
+    uint32_t length;    // number of bytes of text that follow
+} DaemonRequest;
+
+
+// =========================== Client Functions ============================ //
+// Attempts to have a running daemon execute the given command-line arguments.
+// Returns 0 if it did (in which case the exit status is saved to 'status'),
+// and a non-zero value if no daemon could be reached, or the daemon handed
+// the command back (in either case nothing was run, and the command should
+// be run directly).
+int daemon_forward(int argc, char** args, int* status);
+
+
+// =========================== Server Functions ============================ //
+// Starts serving requests on the daemon's socket, and doesn't return until
+// the daemon is stopped (by 'daemon_stop', SIGINT, or SIGTERM). Returns 0
+// once it's stopped, and a non-zero value if it couldn't be started (for
+// example, because another daemon is already running).
+int daemon_serve();
+
+// Returns non-zero if this process is serving requests as the daemon.
+int daemon_is_serving();
+
+// Asks the daemon to stop once it's finished with the current request.
+void daemon_stop();
+
+// Abandons the current request, and has the client run the command itself
+// instead. The caller has to return without changing or printing anything.
+void daemon_hand_back();
+
+#endif
@@ -0,0 +1,203 @@
+// Implements the 'batch' command handler and initializer. A batch is a file
+// (or stdin) holding one ttydo command per line, written just like it would
+// be on the command line (minus the leading 'ttydo', which is optional):
+//
+//      task add groceries "Milk" "Two gallons"
+//      task mark groceries 3
+//      # comments and blank lines are skipped
+//
+// Every command runs in the same process, against the same lists, so each
+// list is loaded once. Saving is deferred while the batch runs: each list
+// that was changed is written out once, at the end (or at every checkpoint).
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "handlers.h"
+#include "../utils.h"
+#include "../pager.h"
+#include "../daemon.h"
+#include "../../scribe.h"
+#include "../../batch.h"
+
+// Constants and function prototypes
+#define BATCH_STDIN "-"                     // reads the batch from stdin
+#define BATCH_CHECKPOINT_OPTION "--checkpoint"
+int handle_batch_help(Command* comm, int argc, char** args);
+int batch_run(Command* comm, FILE* file, long checkpoint);
+
+
+// ============================== Initializer ============================== //
+Command* init_command_batch()
+{
+    // main command
+    Command* result = command_new("Batch", "b", "batch",
+        "Runs many commands (one per line) from a file or stdin, at once.",
+        handle_batch);
+    if (!result) { return NULL; }
+
+    // sub-commands
+    if (command_init_subcommands(result, 1)) { return NULL; }
+    result->subcommands[0] = command_new("Help", "h", "help",
+        "Shows how to write and run a batch.",
+        handle_batch_help);
+    if (!result->subcommands[0]) { return NULL; }
+
+    return result;
+}
+
+
+// ================================ Handler ================================ //
+// The 'batch' command handler
+int handle_batch(Command* comm, int argc, char** args)
+{
+    // make sure our tasklist array has been initialized
+    if (!tasklists)
+    { fatality(1, "Task list array has not been initialized."); }
+
+    // match the help command
+    if (argc > 0 && command_match(comm->subcommands[0], args[0]))
+    { return comm->subcommands[0]->handler(comm, argc - 1, args + 1); }
+
+    // pick out the file (stdin, if there isn't one) and the checkpoint
+    // interval (0, if there isn't one: everything is saved at the end)
+    char* path = BATCH_STDIN;
+    long checkpoint = 0;
+    for (int i = 0; i < argc; i++)
+    {
+        if (!strcmp(args[i], BATCH_CHECKPOINT_OPTION))
+        {
+            char* end = NULL;
+            if (i + 1 < argc) { checkpoint = strtol(args[++i], &end, 10); }
+            if (!end || end == args[i] || *end != '\0' || checkpoint < 0)
+            {
+                eprintf("The checkpoint interval must be a number of commands.\n");
+                return 1;
+            }
+        }
+        else { path = args[i]; }
+    }
+
+    // reading from a terminal or a pipe could keep the daemon waiting on
+    // the user (and every other command waiting on it), so the client runs
+    // those batches itself
+    if (daemon_is_serving())
+    {
+        struct stat info;
+        int result = strcmp(path, BATCH_STDIN) ? stat(path, &info) :
+                                                 fstat(STDIN_FILENO, &info);
+        if (!result && !S_ISREG(info.st_mode))
+        {
+            daemon_hand_back();
+            return 0;
+        }
+    }
+
+    // open the file
+    FILE* file = stdin;
+    if (strcmp(path, BATCH_STDIN))
+    {
+        file = fopen(path, "r");
+        if (!file)
+        {
+            eprintf("Couldn't open batch file \"%s\".\n", path);
+            return 1;
+        }
+    }
+
+    // run every command in it
+    int result = batch_run(comm, file, checkpoint);
+    if (file != stdin) { fclose(file); }
+    return result;
+}
+
+// Handles the 'help' sub-command
+int handle_batch_help(Command* comm, int argc, char** args)
+{
+    print_usage("batch [<FILE>] [" BATCH_CHECKPOINT_OPTION " <COUNT>]");
+    printf("Runs the ttydo command on each line of <FILE> (or stdin, if no file\n"
+           "is given, or it's \"" BATCH_STDIN "\"), like it was typed on the command line.\n");
+    printf("Arguments with spaces can be quoted. Blank lines, and lines starting\n"
+           "with '#', are skipped.\n");
+    printf("Changed lists are saved once, at the end. With " BATCH_CHECKPOINT_OPTION ",\n"
+           "they're also saved after every <COUNT> commands.\n");
+    return 0;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Reads and runs each command in the given file, saving every changed list
+// after each 'checkpoint' commands (if it's positive) and at the end. (The
+// batch command itself is given, so it can't be run from inside the batch.)
+// Returns 0 if every command succeeded and every list was saved, and a
+// non-zero value otherwise.
+int batch_run(Command* comm, FILE* file, long checkpoint)
+{
+    // changes aren't written until a checkpoint (or the end), and lists are
+    // printed out in full rather than in the pager
+    defer_task_list_saves(1);
+    pager_set_enabled(0);
+
+    char* line = NULL;
+    size_t capacity = 0;
+    int line_number = 0;
+    int count = 0;
+    int failed = 0;
+    int save_failed = 0;
+    while (getline(&line, &capacity, file) >= 0)
+    {
+        line_number++;
+
+        // split the line into arguments (skipping a leading "ttydo"). If
+        // there aren't any, it was a blank line or a comment
+        char* args[BATCH_MAX_ARGS];
+        int argc = batch_split_line(line, args, BATCH_MAX_ARGS);
+        if (argc < 0)
+        {
+            eprintf("Line %d: unterminated quote or too many arguments.\n",
+                    line_number);
+            failed++;
+            continue;
+        }
+        if (argc == 0) { continue; }
+
+        // batches can't run other batches
+        if (command_match(comm, args[0]))
+        {
+            eprintf("Line %d: batches can't be nested.\n", line_number);
+            failed++;
+            continue;
+        }
+
+        // run the command
+        int result = execute_command(argc, args);
+        if (result < 0)
+        {
+            eprintf("Line %d: command not found: \"%s\".\n", line_number,
+                    args[0]);
+        }
+        failed += result != 0;
+
+        // at every checkpoint, save what's changed so far
+        count++;
+        if (checkpoint > 0 && count % checkpoint == 0)
+        {
+            save_failed |= tasklist_array_save_dirty() != 0;
+            tasklist_array_sync();
+        }
+    }
+    free(line);
+
+    // save every list that's been changed
+    defer_task_list_saves(0);
+    pager_set_enabled(1);
+    save_failed |= tasklist_array_save_dirty() != 0;
+    if (save_failed) { eprintf("Failed to save every changed task list.\n"); }
+    if (failed) { eprintf("%d of the batch's commands failed.\n", failed); }
+    return failed || save_failed;
+}
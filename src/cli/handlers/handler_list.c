@@ -7,8 +7,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include "handlers.h"
 #include "../utils.h"
+#include "../pager.h"
 #include "../../scribe.h"
 
 // Function prototypes
@@ -18,6 +20,7 @@ int handle_list_delete(Command* comm, int argc, char** args);
 int handle_list_rename(Command* comm, int argc, char** args);
 int handle_list_color(Command* comm, int argc, char** args);
 int handle_list_view(Command* comm, int argc, char** args);
+int handle_list_convert(Command* comm, int argc, char** args);
 int list_name_is_valid(char* name);
 
 
@@ -31,7 +34,7 @@ Command* init_command_list()
     if (!result) { return NULL; }
     
     // sub-commands
-    if (command_init_subcommands(result, 6)) { return NULL; }
+    if (command_init_subcommands(result, 7)) { return NULL; }
     result->subcommands[0] = command_new("Help", "h", "help",
         "Shows a list of supported sub-commands.",
         handle_list_help);
@@ -50,6 +53,9 @@ Command* init_command_list()
     result->subcommands[5] = command_new("View/Verbose", "v", "view",
         "Displays all tasks in the list, their numbers, and their full descriptions.",
         handle_list_view);
+    result->subcommands[6] = command_new("Convert", "f", "convert",
+        "Converts a task list's file between the text and binary formats.",
+        handle_list_convert);
 
     // check each sub-command - if one wasn't initialized, return NULL
     for (int i = 0; i < result->subcommands_length; i++)
@@ -105,7 +111,7 @@ int handle_list(Command* comm, int argc, char** args)
             int text_max_length = TASK_LIST_NAME_MAX_LENGTH + 8;
             char text[text_max_length];
             memset(text, 0, text_max_length);
-            snprintf(text, text_max_length, "%s", tasklists[i]->name);
+            snprintf(text, text_max_length, "%s", tasklist_array_entry(i)->name);
             print_list_item(i + 1, text);
         }
         return 0;
@@ -130,16 +136,25 @@ int handle_list(Command* comm, int argc, char** args)
     if (index >= 0)
     {
         // if the task list has tasks, print it as a box stack
-        if (tasklists[index]->size > 0)
+        TaskList* list = tasklist_array_get(index);
+        if (list->size > 0)
         {
-            BoxStack* bs = task_list_to_box_stack(tasklists[index], 1);
-            if (!bs) { eprintf("Couldn't print task list."); }
-            // print the box stack
-            box_stack_print(bs);
-            box_stack_free(bs);
+            // if it's too long to fit on the screen, show it in the pager
+            if (pager_needed(list->size))
+            { return pager_show_task_list(list); }
+
+            // otherwise, render it straight to the terminal, a chunk at a
+            // time
+            OutputBuffer* out = output_buffer_new();
+            if (!out) { fatality(1, "Failed to allocate memory for output."); }
+            output_buffer_stream(out, STDOUT_FILENO);
+            int failed = task_list_render(list, 1, out);
+            output_buffer_flush(out, STDOUT_FILENO);
+            output_buffer_free(out);
+            if (failed) { eprintf("Couldn't print task list."); }
         }
         else
-        { printf("The list '%s' has no tasks.\n", tasklists[index]->name); }
+        { printf("The list '%s' has no tasks.\n", list->name); }
     }
     else
     {
@@ -276,8 +291,6 @@ int handle_list_rename(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 0;
     }
-    TaskList* list = tasklists[index];
-
     // make a local copy of the proposed new name, with length restrictions
     char new_name[TASK_LIST_NAME_MAX_LENGTH + 1] = {'\0'};
     snprintf(new_name, TASK_LIST_NAME_MAX_LENGTH + 1, "%s", args[1]);
@@ -289,14 +302,8 @@ int handle_list_rename(Command* comm, int argc, char** args)
         return 1;
     }
 
-    // delete the old list file from memory
-    if (delete_task_list(list))
-    { eprintf("Couldn't delete old list file.\n"); }
-
-    // duplicate the new name and save the list to a new file
-    free(list->name);
-    list->name = strdup(new_name);
-    return save_task_list(list);
+    // move the list over to its new name (and file)
+    return tasklist_array_rename(index, new_name);
 }
 
 int handle_list_color(Command* comm, int argc, char** args)
@@ -324,7 +331,7 @@ int handle_list_color(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 0;
     }
-    TaskList* list = tasklists[index];
+    TaskList* list = tasklist_array_get(index);
 
     // get the length of the given color value
     char* value = args[1];
@@ -377,25 +384,62 @@ int handle_list_view(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 0;
     }
-    TaskList* list = tasklists[index];
+    TaskList* list = tasklist_array_get(index);
     
-    // print the list's title, then iterate across the list's linked elements to
-    // retrieve each task
+    // print the list's title, then iterate across the list's tasks
     printf("%s\n", list->name);
-    int i = 0;
-    TaskListElem* current = list->head;
-    while (i++ < list->size && current)
+    for (int i = 0; i < list->size; i++)
     {
-        char* tstr = task_to_string(current->task);
-        printf("%d. %s\n", i, tstr);
+        char* tstr = task_to_string(list->tasks[i]);
+        printf("%d. %s\n", i + 1, tstr);
         free(tstr);
-
-        // move to the next task
-        current = current->next;
     }
     return 0;
 }
 
+// Handles the 'convert' sub-command
+int handle_list_convert(Command* comm, int argc, char** args)
+{
+    // check for the correct command-line arguments
+    if (argc < 2)
+    {
+        print_usage("list convert <LIST> <FORMAT>");
+        printf("Where <LIST> is either a list's name or number.\n");
+        printf("Where <FORMAT> is either \"text\" or \"binary\".\n");
+        return 0;
+    }
+
+    // if we don't have any task lists, there's no point
+    if (tasklist_array_length == 0)
+    {
+        printf("You don't have any task lists.\n");
+        return 0;
+    }
+
+    // attempt to find the index of the matching task list
+    int index = tasklist_array_find(args[0]);
+    if (index < 0)
+    {
+        eprintf("Couldn't find a task list with name/number \"%s\".\n", args[0]);
+        fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
+        return 0;
+    }
+
+    // match the format
+    int format = -1;
+    if (!strcmp(args[1], "text")) { format = TASK_LIST_FORMAT_TEXT; }
+    else if (!strcmp(args[1], "binary")) { format = TASK_LIST_FORMAT_BINARY; }
+    if (format < 0)
+    {
+        eprintf("Unknown format \"%s\". (Try \"text\" or \"binary\")\n", args[1]);
+        return 1;
+    }
+
+    // set the list's format and re-write it in full
+    TaskList* list = tasklist_array_get(index);
+    list->format = format;
+    return save_task_list(list);
+}
 
 // =========================== Helper Functions ============================ //
 // Checks a given string to see if it's a valid list name. Returns 1 if so and
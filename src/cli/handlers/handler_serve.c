@@ -0,0 +1,113 @@
+// Implements the 'serve' command handler and initializer. 'ttydo serve' runs
+// ttydo as a daemon (see daemon.h): it keeps task lists loaded in memory,
+// and every other ttydo command hands its work over to it, rather than
+// loading lists from scratch each time.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "handlers.h"
+#include "../utils.h"
+#include "../daemon.h"
+#include "../../scribe.h"
+
+// Function prototypes
+int handle_serve_help(Command* comm, int argc, char** args);
+int handle_serve_stop(Command* comm, int argc, char** args);
+
+
+// ============================== Initializer ============================== //
+Command* init_command_serve()
+{
+    // main command
+    Command* result = command_new("Serve", "s", "serve",
+        "Runs ttydo as a daemon, keeping your lists loaded for other commands.",
+        handle_serve);
+    if (!result) { return NULL; }
+
+    // sub-commands
+    if (command_init_subcommands(result, 2)) { return NULL; }
+    result->subcommands[0] = command_new("Help", "h", "help",
+        "Shows how the daemon works.",
+        handle_serve_help);
+    result->subcommands[1] = command_new("Stop", "x", "stop",
+        "Stops the running daemon.",
+        handle_serve_stop);
+
+    // check each sub-command - if one wasn't initialized, return NULL
+    for (int i = 0; i < result->subcommands_length; i++)
+    {
+        if (!result->subcommands[i])
+        { return NULL; }
+    }
+
+    return result;
+}
+
+
+// ================================ Handler ================================ //
+// The 'serve' command handler
+int handle_serve(Command* comm, int argc, char** args)
+{
+    // try to match sub-commands
+    if (argc > 0)
+    {
+        for (int i = 0; i < comm->subcommands_length; i++)
+        {
+            Command* sub = comm->subcommands[i];
+            if (command_match(sub, args[0]))
+            { return sub->handler(sub, argc - 1, args + 1); }
+        }
+
+        eprintf("Sub-Command not found. (Try 'ttydo serve help')\n");
+        return 1;
+    }
+
+    // if we're the daemon, this command was handed to us by another ttydo
+    // process, so there's already a daemon running
+    if (daemon_is_serving())
+    {
+        printf("The ttydo daemon is already running.\n");
+        return 0;
+    }
+    if (task_list_saves_deferred())
+    {
+        eprintf("The daemon can't be started from inside a batch.\n");
+        return 1;
+    }
+    return daemon_serve();
+}
+
+// Handles the 'help' sub-command
+int handle_serve_help(Command* comm, int argc, char** args)
+{
+    print_usage("serve [stop]");
+    printf("Starts the ttydo daemon, which runs until it's stopped with 'ttydo serve stop'\n"
+           "(or Ctrl-C). While it's running, every other ttydo command is run by the\n"
+           "daemon, which keeps your lists loaded, rather than loading them each time.\n");
+    printf("Commands are run one at a time, and every change is saved before the\n"
+           "command finishes. Lists changed by anything else are reloaded.\n");
+    printf("Commands that wait on you (the pager, or a batch read from stdin or a\n"
+           "pipe) are still run directly, so they never hold up the daemon.\n");
+    printf("To keep it running in the background, run 'ttydo serve &'.\n");
+    return 0;
+}
+
+// Handles the 'stop' sub-command
+int handle_serve_stop(Command* comm, int argc, char** args)
+{
+    // if a daemon were running, it would have been handed this command
+    if (!daemon_is_serving())
+    {
+        printf("The ttydo daemon isn't running.\n");
+        return 0;
+    }
+
+    // stop once this command has been answered
+    daemon_stop();
+    printf("Stopping the ttydo daemon.\n");
+    return 0;
+}
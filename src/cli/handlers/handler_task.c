@@ -9,6 +9,7 @@
 #include "handlers.h"
 #include "../utils.h"
 #include "../../scribe.h"
+#include "../../journal.h"
 #include "../../visual/colors.h"
 
 // Function prototypes
@@ -96,27 +97,20 @@ int handle_task(Command* comm, int argc, char** args)
         print_horizontal_line(strlen(message));
         
         // otherwise, iterate through each task list and print out statistics
+        // (straight from the manifest - no lists need to be loaded)
         for (int i = 0; i < tasklist_array_length; i++)
         {
-            // count the number of completed tasks for this list
-            int completions = 0;
-            TaskListElem* current = tasklists[i]->head;
-            int j = 0;
-            while (j < tasklists[i]->size && current)
-            {
-                completions += current->task->is_complete;
-                current = current->next;
-            }
+            ManifestEntry* entry = tasklist_array_entry(i);
 
             // print out information about the task list
             int text_max_length = TASK_LIST_NAME_MAX_LENGTH + 32;
             char text[text_max_length];
             memset(text, 0, text_max_length);
-            snprintf(text, text_max_length, "%s - ", tasklists[i]->name);
-            if (tasklists[i]->size > 0)
+            snprintf(text, text_max_length, "%s - ", entry->name);
+            if (entry->size > 0)
             {
                 snprintf(text + strlen(text), 64, "%d/%d completed",
-                         completions, tasklists[i]->size);
+                         entry->completed, entry->size);
             }
             else
             { snprintf(text + strlen(text), 6, "empty"); }
@@ -197,16 +191,19 @@ int handle_task_add(Command* comm, int argc, char** args)
     replace_string_non_printables(title, title_length);
     replace_string_non_printables(desc, desc_length);
 
-    // create the new task
-    Task* task = task_new(title, desc);
+    // create the new task (from the list's arena, if it has one), then add
+    // it to the list. (Changes are recorded by task ID, so we'll make sure no
+    // other task in the list shares the new one's ID)
+    TaskList* list = tasklist_array_get(index);
+    Task* task = task_new_in_arena(title, desc, list->arena);
     if (!task) { fatality(1, "Failed to allocate memory for a new task."); }
-
-    // add it to the correct list
-    if (task_list_append(tasklists[index], task))
+    while (task_list_get_by_id(list, task->id))
+    { task->id = task_generate_id(); }
+    if (task_list_append(list, task))
     { fatality(1, "Failed to add the task to the list."); }
 
-    // save the task list
-    if (save_task_list(tasklists[index]))
+    // record the new task
+    if (journal_record(list, JOURNAL_OP_ADD, task))
     { fatality(1, "Failed to write the new task to disk."); }
 
     return 0;
@@ -242,7 +239,7 @@ int handle_task_delete(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -275,9 +272,10 @@ int handle_task_delete(Command* comm, int argc, char** args)
     if (!task_list_remove(list, task))
     { fatality(1, "Failed to remove task from the list.\n"); }
     
-    // free the removed task's memory and save the task list
+    // record the removal and free the removed task's memory
+    int record_result = journal_record(list, JOURNAL_OP_REMOVE, task);
     task_free(task);
-    if (save_task_list(list))
+    if (record_result)
     { fatality(1, "Failed to write to disk."); }
 
     return 0;
@@ -313,7 +311,7 @@ int handle_task_view(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -389,7 +387,7 @@ int handle_task_mark(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -419,10 +417,10 @@ int handle_task_mark(Command* comm, int argc, char** args)
     free(title);
 
     // invert the 'is_complete' flag for the task
-    task->is_complete = !task->is_complete;
+    task_list_set_task_complete(list, task, !task->is_complete);
     
-    // save the task list
-    if (save_task_list(list))
+    // record the change
+    if (journal_record(list, JOURNAL_OP_COMPLETE, task))
     { fatality(1, "Failed to write to disk."); }
 
     return 0;
@@ -471,7 +469,7 @@ int handle_task_edit(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -495,24 +493,16 @@ int handle_task_edit(Command* comm, int argc, char** args)
     }
     free(title);
 
-    // get the length of the given value
-    char* value = args[3];
-    int value_length = strlen(value);
     // adjust the correct field, depending on the edit code
+    char* value = args[3];
     if (edit_code == 1)
-    {
-        task->title = realloc(task->title, (value_length + 1) * sizeof(char));
-        snprintf(task->title, value_length + 1, "%s", value);
-    }
+    { task_list_set_task_title(list, task, value); }
     else if (edit_code == 2)
-    {
-        task->description = realloc(task->description,
-                                    (value_length + 1) * sizeof(char));
-        snprintf(task->description, value_length + 1, "%s", value);
-    }
+    { task_set_description(task, value); }
     
-    // save the task list
-    if (save_task_list(list))
+    // record the change
+    JournalOp op = edit_code == 1 ? JOURNAL_OP_TITLE : JOURNAL_OP_DESCRIPTION;
+    if (journal_record(list, op, task))
     { fatality(1, "Failed to write to disk."); }
 
     return 0;
@@ -546,7 +536,7 @@ int handle_task_color(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -593,8 +583,8 @@ int handle_task_color(Command* comm, int argc, char** args)
     // set the color
     task_set_color(task, value);
     
-    // save the task list
-    if (save_task_list(list))
+    // record the change
+    if (journal_record(list, JOURNAL_OP_COLOR, task))
     { fatality(1, "Failed to write to disk."); }
     return 0;
 }
@@ -627,7 +617,7 @@ int handle_task_order(Command* comm, int argc, char** args)
         fprintf(stderr, "Numbers must be between 1 and %d.\n", tasklist_array_length);
         return 1;
     }
-    TaskList* list = tasklists[tl_index];
+    TaskList* list = tasklist_array_get(tl_index);
 
     // if the list has no entries, return
     if (list->size == 0)
@@ -661,15 +651,6 @@ int handle_task_order(Command* comm, int argc, char** args)
     }
     index--;
 
-    // determine the task's current index in the list
-    TaskListElem* elem = list->head;
-    int elem_index = 0;
-    while (elem_index++ < list->size && elem)
-    {
-        if (elem->task == task)
-        { break; }
-        elem = elem->next;
-    }
     // if they requested the end of the list, decrement the index by one
     if (index == list->size)
     { index--; }
@@ -682,8 +663,8 @@ int handle_task_order(Command* comm, int argc, char** args)
         return 1;
     }
     
-    // save the task list
-    if (save_task_list(list))
+    // record the move
+    if (journal_record(list, JOURNAL_OP_MOVE, task))
     { fatality(1, "Failed to write to disk."); }
 
     return 0;
@@ -768,30 +749,11 @@ int mark_all_tasks(TaskList* list)
 {
     if (!list) { return 1; }
 
-    // iterate through every task in the list and count the completions. Mark
-    // any incomplete tasks as completed.
-    int completions = 0;
+    // if all of the tasks are already complete, we'll mark them all as
+    // incomplete. Otherwise, every task is marked as complete
+    int is_complete = list->completed_count < list->size;
     for (int i = 0; i < list->size; i++)
-    {
-        Task* task = task_list_get_by_index(list, i);
-        if (!task) { continue; }
-
-        // if the task isn't complete, mark it as so. Otherwise, if it's
-        // already complete, increment the counter
-        if (!task->is_complete) { task->is_complete = 1; }
-        else { completions++; }
-    }
-
-    // if all of the tasks were already complete, we'll mark them all as
-    // incomplete
-    if (completions == list->size)
-    {
-        for (int i = 0; i < list->size; i++)
-        {
-            Task* task = task_list_get_by_index(list, i);
-            if (task) { task->is_complete = 0; }
-        }
-    }
+    { task_list_set_task_complete(list, list->tasks[i], is_complete); }
 
     // write the modified list to disk
     return save_task_list(list);
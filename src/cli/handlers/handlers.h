@@ -7,6 +7,7 @@
 
 // Module inclusions
 #include "../command.h"
+#include "../utils.h"
 #include "../../tasklist.h"
 
 // ============================ Globals/Macros ============================= //
@@ -18,7 +19,9 @@ extern Command** commands;  // reference to command array
 // Task list globals
 extern int tasklist_array_capacity; // global task list array capacity
 extern int tasklist_array_length;   // global task list array length
-extern TaskList** tasklists;        // global task list array
+extern TaskListHandle* tasklists;   // global task list array
+// Runs a command (see controller.c)
+extern int execute_command(int argc, char** args);
 
 
 // =========================== Handler Functions =========================== //
@@ -42,4 +45,14 @@ extern int handle_task(Command* comm, int argc, char** args);
 // The 'task' command initializer
 extern Command* init_command_task();
 
+// The 'batch' command handler
+extern int handle_batch(Command* comm, int argc, char** args);
+// The 'batch' command initializer
+extern Command* init_command_batch();
+
+// The 'serve' command handler
+extern int handle_serve(Command* comm, int argc, char** args);
+// The 'serve' command initializer
+extern Command* init_command_serve();
+
 #endif
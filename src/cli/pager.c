@@ -0,0 +1,403 @@
+// A module that implements pager.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+#include "pager.h"
+#include "daemon.h"
+#include "../visual/terminal.h"
+#include "../visual/width.h"
+#include "../visual/colors.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+// terminal control sequences
+#define PAGER_ENTER "\033[?1049h\033[?25l"  // alternate screen, hide cursor
+#define PAGER_EXIT "\033[?25h\033[?1049l"   // show cursor, main screen
+#define PAGER_CLEAR "\033[H\033[J"          // move to the top-left and clear
+
+// keys (anything that isn't a single byte is numbered above 255)
+#define PAGER_KEY_NONE -1               // nothing was read (try again)
+#define PAGER_KEY_ERROR -2              // the terminal can't be read
+#define PAGER_KEY_ESCAPE 0x1B
+#define PAGER_KEY_UP 256
+#define PAGER_KEY_DOWN 257
+#define PAGER_KEY_PAGE_UP 258
+#define PAGER_KEY_PAGE_DOWN 259
+#define PAGER_KEY_HOME 260
+#define PAGER_KEY_END 261
+
+// The control sequences (after the "ESC [") sent for special keys
+typedef struct _PagerSequence
+{
+    char* sequence;
+    int key;
+} PagerSequence;
+static const PagerSequence pager_sequences[] = {
+    {"A", PAGER_KEY_UP}, {"B", PAGER_KEY_DOWN},
+    {"5~", PAGER_KEY_PAGE_UP}, {"6~", PAGER_KEY_PAGE_DOWN},
+    {"H", PAGER_KEY_HOME}, {"1~", PAGER_KEY_HOME}, {"7~", PAGER_KEY_HOME},
+    {"F", PAGER_KEY_END}, {"4~", PAGER_KEY_END}, {"8~", PAGER_KEY_END}
+};
+#define PAGER_SEQUENCE_COUNT ((int) (sizeof(pager_sequences) / sizeof(PagerSequence)))
+
+// The 'Pager' struct holds everything the pager needs to know while it's
+// running.
+typedef struct _Pager
+{
+    TaskList* list;         // the list being shown
+    int top;                // index of the first visible task
+    int rows;               // number of tasks that fit on the screen
+    int match;              // index of the last search match (-1 if none)
+    char prompt_type;       // '/' or ':' while a prompt is open ('\0' if not)
+    char prompt[PAGER_PROMPT_MAX_LENGTH + 1];   // text typed at the prompt
+    int prompt_length;
+    char search[PAGER_PROMPT_MAX_LENGTH + 1];   // last text searched for
+    char message[PAGER_PROMPT_MAX_LENGTH * 2];  // shown until the next key
+    unsigned char input[16];    // bytes read from the terminal, not yet used
+    int input_length;
+} Pager;
+
+int pager_enabled = 1; // whether the pager may be used
+
+int pager_read_key(Pager* pager);
+void pager_draw(Pager* pager, OutputBuffer* out);
+void pager_scroll_to(Pager* pager, int top);
+int pager_handle_key(Pager* pager, int key);
+void pager_handle_prompt_key(Pager* pager, int key);
+void pager_search(Pager* pager, int direction);
+int task_matches(Task* task, char* text);
+
+
+// ============================ Pager Functions ============================ //
+int pager_needed(int rows)
+{
+    if (!pager_enabled) { return 0; }
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) { return 0; }
+    int height = get_terminal_height();
+    return height > PAGER_CHROME_HEIGHT && rows + PAGER_CHROME_HEIGHT > height;
+}
+
+void pager_set_enabled(int enabled)
+{ pager_enabled = enabled != 0; }
+
+int pager_show_task_list(TaskList* list)
+{
+    if (!list) { return 1; }
+
+    // the daemon can't wait on one user's keys while others are waiting on
+    // it, so the client shows the pager itself
+    if (daemon_is_serving())
+    {
+        daemon_hand_back();
+        return 0;
+    }
+
+    // put the terminal in raw mode: keys are read as they're pressed,
+    // without being echoed, and Ctrl-C comes to us as a key (so the terminal
+    // always gets put back the way it was)
+    struct termios saved;
+    if (tcgetattr(STDIN_FILENO, &saved)) { return 1; }
+    struct termios raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO | ISIG | IEXTEN);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    OutputBuffer* out = output_buffer_new();
+    if (!out || tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw))
+    {
+        output_buffer_free(out);
+        return 1;
+    }
+
+    // redraw whenever the terminal is resized (a resize interrupts the wait
+    // for the next key)
+    terminal_watch_resize(1);
+
+    // draw a screen, wait for a key, and repeat until the user quits
+    Pager pager;
+    memset(&pager, 0, sizeof(Pager));
+    pager.list = list;
+    pager.match = -1;
+    output_string(out, PAGER_ENTER);
+    int quit = 0;
+    while (!quit)
+    {
+        pager_draw(&pager, out);
+        if (output_buffer_flush(out, STDOUT_FILENO)) { break; }
+
+        int key = pager_read_key(&pager);
+        if (key == PAGER_KEY_ERROR) { break; }
+        if (key == PAGER_KEY_NONE) { continue; }
+        pager.message[0] = '\0';
+        if (pager.prompt_type) { pager_handle_prompt_key(&pager, key); }
+        else { quit = pager_handle_key(&pager, key); }
+    }
+
+    // put everything back
+    output_string(out, PAGER_EXIT);
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
+    terminal_watch_resize(0);
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+    return 0;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Waits for the next key to be pressed and returns it: either a single byte,
+// or one of the PAGER_KEY_* values.
+int pager_read_key(Pager* pager)
+{
+    // if we've used up everything we read last time, read some more. (A key
+    // like an arrow key arrives as several bytes at once, and anything typed
+    // or pasted quickly may arrive along with it)
+    if (pager->input_length == 0)
+    {
+        if (terminal_was_resized()) { return PAGER_KEY_NONE; }
+        ssize_t length = read(STDIN_FILENO, pager->input, sizeof(pager->input));
+        if (length < 0 && errno == EINTR) { return PAGER_KEY_NONE; }
+        if (length <= 0) { return PAGER_KEY_ERROR; }
+        pager->input_length = length;
+    }
+
+    // most keys are a single byte. The special ones we know about are sent
+    // as control sequences: "ESC [", then any parameters, then a final byte
+    int key = pager->input[0];
+    int used = 1;
+    if (key == PAGER_KEY_ESCAPE && pager->input_length > 2 &&
+        pager->input[1] == '[')
+    {
+        used = 2;
+        while (used < pager->input_length &&
+               (pager->input[used] < 0x40 || pager->input[used] > 0x7E))
+        { used++; }
+        if (used < pager->input_length) { used++; }
+
+        // look the sequence up (anything we don't know about is ignored)
+        key = PAGER_KEY_NONE;
+        for (int i = 0; i < PAGER_SEQUENCE_COUNT; i++)
+        {
+            int length = strlen(pager_sequences[i].sequence);
+            if (length == used - 2 &&
+                !memcmp(pager->input + 2, pager_sequences[i].sequence, length))
+            { key = pager_sequences[i].key; }
+        }
+    }
+
+    // take the key's bytes out of the input
+    pager->input_length -= used;
+    memmove(pager->input, pager->input + used, pager->input_length);
+    return key;
+}
+
+// Renders the visible part of the list, and the status line below it, into
+// the given buffer.
+void pager_draw(Pager* pager, OutputBuffer* out)
+{
+    // work out how many tasks fit (the terminal may have been resized since
+    // the last time), then draw only those
+    int width = get_terminal_width();
+    pager->rows = get_terminal_height() - PAGER_CHROME_HEIGHT;
+    if (pager->rows < 1) { pager->rows = 1; }
+    pager_scroll_to(pager, pager->top);
+    output_string(out, PAGER_CLEAR);
+    task_list_render_range(pager->list, width, pager->top,
+                           pager->top + pager->rows, out);
+
+    // the status line shows an open prompt, a message, or where we are in
+    // the list (and how to get out)
+    char status[PAGER_PROMPT_MAX_LENGTH * 2 + 32];
+    int last = pager->top + pager->rows;
+    if (last > pager->list->size) { last = pager->list->size; }
+    if (pager->prompt_type)
+    {
+        snprintf(status, sizeof(status), "%c%s", pager->prompt_type,
+                 pager->prompt);
+    }
+    else if (pager->message[0])
+    { snprintf(status, sizeof(status), "%s", pager->message); }
+    else
+    {
+        snprintf(status, sizeof(status),
+                 "Tasks %d-%d of %d (q: quit, /: search, :: jump to task)",
+                 pager->top + 1, last, pager->list->size);
+    }
+
+    // (the status line is kept out of the last column, so the terminal
+    // never scrolls)
+    int length = display_width_prefix(status, strlen(status), width - 1, NULL);
+    output_string(out, C_BOX);
+    output_append(out, status, length);
+    output_string(out, C_NONE);
+}
+
+// Scrolls the pager so the given task is at the top of the screen. The pager
+// never scrolls past the beginning of the list, or so far that the end of the
+// list doesn't fill the screen.
+void pager_scroll_to(Pager* pager, int top)
+{
+    if (top > pager->list->size - pager->rows)
+    { top = pager->list->size - pager->rows; }
+    if (top < 0) { top = 0; }
+    pager->top = top;
+}
+
+// Handles a key pressed while no prompt is open. Returns non-zero if the
+// pager should quit.
+int pager_handle_key(Pager* pager, int key)
+{
+    // moving around by hand means the next search starts from what's shown
+    if (key != 'n' && key != 'N') { pager->match = -1; }
+
+    switch (key)
+    {
+        case 'q':
+        case 'Q':
+        case 3: // Ctrl-C
+            return 1;
+        case 'j':
+        case '\r':
+        case '\n':
+        case PAGER_KEY_DOWN:
+            pager_scroll_to(pager, pager->top + 1);
+            break;
+        case 'k':
+        case PAGER_KEY_UP:
+            pager_scroll_to(pager, pager->top - 1);
+            break;
+        case ' ':
+        case 'f':
+        case PAGER_KEY_PAGE_DOWN:
+            pager_scroll_to(pager, pager->top + pager->rows);
+            break;
+        case 'b':
+        case PAGER_KEY_PAGE_UP:
+            pager_scroll_to(pager, pager->top - pager->rows);
+            break;
+        case 'g':
+        case PAGER_KEY_HOME:
+            pager_scroll_to(pager, 0);
+            break;
+        case 'G':
+        case PAGER_KEY_END:
+            pager_scroll_to(pager, pager->list->size);
+            break;
+        case '/':
+        case ':':
+            pager->prompt_type = key;
+            pager->prompt_length = 0;
+            pager->prompt[0] = '\0';
+            break;
+        case 'n':
+            pager_search(pager, 1);
+            break;
+        case 'N':
+            pager_search(pager, -1);
+            break;
+    }
+    return 0;
+}
+
+// Handles a key pressed while a prompt is open: it's either typed into the
+// prompt, or it closes the prompt (and, with Enter, does what was asked).
+void pager_handle_prompt_key(Pager* pager, int key)
+{
+    // Escape and Ctrl-C close the prompt without doing anything
+    if (key == PAGER_KEY_ESCAPE || key == 3)
+    {
+        pager->prompt_type = '\0';
+        return;
+    }
+
+    // backspace removes the last character (all of its bytes, if it's UTF-8)
+    if (key == 127 || key == '\b')
+    {
+        while (pager->prompt_length > 0 &&
+               (pager->prompt[pager->prompt_length - 1] & 0xC0) == 0x80)
+        { pager->prompt_length--; }
+        if (pager->prompt_length > 0) { pager->prompt_length--; }
+        pager->prompt[pager->prompt_length] = '\0';
+        return;
+    }
+
+    // anything printable is added to the prompt
+    if (key != '\r' && key != '\n')
+    {
+        if (key >= 32 && key < 256 && key != 127 &&
+            pager->prompt_length < PAGER_PROMPT_MAX_LENGTH)
+        {
+            pager->prompt[pager->prompt_length++] = key;
+            pager->prompt[pager->prompt_length] = '\0';
+        }
+        return;
+    }
+
+    // Enter: jump to the task number, or search for the text (an empty
+    // search repeats the last one)
+    if (pager->prompt_type == ':')
+    {
+        int number = atoi(pager->prompt);
+        if (number >= 1 && number <= pager->list->size)
+        { pager_scroll_to(pager, number - 1); }
+        else
+        {
+            snprintf(pager->message, sizeof(pager->message),
+                     "There's no task number '%s'.", pager->prompt);
+        }
+    }
+    else
+    {
+        if (pager->prompt_length > 0)
+        {
+            memcpy(pager->search, pager->prompt, pager->prompt_length + 1);
+            pager->match = -1;
+        }
+        pager_search(pager, 1);
+    }
+    pager->prompt_type = '\0';
+}
+
+// Searches for the next task (in the given direction, wrapping around the
+// list) whose title or description contains the last searched-for text, and
+// scrolls to it.
+void pager_search(Pager* pager, int direction)
+{
+    if (!pager->search[0])
+    {
+        snprintf(pager->message, sizeof(pager->message),
+                 "Nothing to search for. (Press '/' to search.)");
+        return;
+    }
+
+    // start from the last match, or from what's on the screen
+    int size = pager->list->size;
+    int start = pager->match;
+    if (start < 0) { start = direction > 0 ? pager->top - 1 : pager->top; }
+    for (int step = 1; step <= size; step++)
+    {
+        int index = ((start + step * direction) % size + size) % size;
+        if (task_matches(pager->list->tasks[index], pager->search))
+        {
+            pager->match = index;
+            pager_scroll_to(pager, index);
+            snprintf(pager->message, sizeof(pager->message),
+                     "Task %d matches '%s'.", index + 1, pager->search);
+            return;
+        }
+    }
+    snprintf(pager->message, sizeof(pager->message),
+             "No tasks match '%s'.", pager->search);
+}
+
+// Returns non-zero if the task's title or description contains the text.
+int task_matches(Task* task, char* text)
+{
+    return (task->title && strstr(task->title, text)) ||
+           (task->description && strstr(task->description, text));
+}
@@ -0,0 +1,46 @@
+// This header file defines a simple pager for viewing task lists that are too
+// long to fit on the terminal. The pager takes over the terminal (putting it
+// in raw mode, on the alternate screen) and only ever draws the tasks that
+// are currently visible, so scrolling through a huge list costs no more than
+// scrolling through a short one.
+//
+// Keys:
+//  - j/k (or the arrow keys, or Enter)     scroll down/up one task
+//  - space/b (or Page Down/Page Up)        scroll down/up one page
+//  - g/G (or Home/End)                     jump to the top/bottom
+//  - :<number>                             jump to a task number
+//  - /<text>                               search titles and descriptions
+//  - n/N                                   find the next/previous match
+//  - q                                     quit
+//
+//      Connor Shugg
+
+#ifndef PAGER_H
+#define PAGER_H
+
+// Module inclusions
+#include "../tasklist.h"
+
+// ========================= Constants and Macros ========================== //
+#define PAGER_CHROME_HEIGHT 5       // lines taken up by everything but tasks
+#define PAGER_PROMPT_MAX_LENGTH 128 // max number of chars typed at a prompt
+
+
+// ============================ Pager Functions ============================ //
+// Returns non-zero if 'rows' lines of tasks are too many to show on the
+// terminal at once, and the pager can be used to show them instead (both
+// stdin and stdout have to be a terminal, and the pager has to be enabled).
+int pager_needed(int rows);
+
+// Enables (if 'enabled' is non-zero) or disables the pager. It's enabled by
+// default, and disabled while running commands that aren't typed in by the
+// user (such as in a batch).
+void pager_set_enabled(int enabled);
+
+// Shows the given task list in the pager, and returns once the user quits.
+// Returns 0 on success and a non-zero value on failure (in which case the
+// terminal is left as it was). In the daemon, the command is handed back to
+// the client instead (see daemon.h).
+int pager_show_task_list(TaskList* list);
+
+#endif
@@ -8,9 +8,16 @@
 #include <string.h>
 #include <stdarg.h>
 #include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include "utils.h"
+#include "../filebatch.h"
+#include "../taskbin.h"
+#include "../visual/width.h"
 #include "../visual/terminal.h"
 #include "../scribe.h"
+#include "../hashindex.h"
 
 // ======================= Globals/Macros/Prototypes ======================= //
 // Command globals
@@ -19,9 +26,53 @@ extern Command** commands;  // dynamically-allocated command array
 // Task list globals
 extern int tasklist_array_capacity; // initial cap of our global tasklist array
 extern int tasklist_array_length;   // number of task lists in the array
-extern TaskList** tasklists;        // global array of task lists
+extern TaskListHandle* tasklists;   // global array of task list handles
+int tasklist_manifest_dirty = 0;    // whether the manifest needs rewriting
+HashIndex* tasklist_name_index = NULL; // list name hash --> array index + 1
+jmp_buf* fatality_recovery_point = NULL; // where 'fatality' jumps to, if set
+struct timespec tasklist_home_mtime;   // home directory's mtime, when synced
+#define TASKLIST_PRELOAD_MAX_THREADS 32 // most threads used to load lists
+
+// A list waiting to be loaded by a preloading thread. If its file has already
+// been read (by the batch reader), the thread parses the contents it was
+// given. Otherwise, it loads the file itself.
+typedef struct _TaskListPreloadJob
+{
+    int index;              // index of the list in the global array
+    char* data;             // the file's contents (NULL if it wasn't read)
+    size_t length;          // length of 'data'
+    struct stat stats;      // the file's stats (if it was read)
+} TaskListPreloadJob;
+
+// Shared state for the threads that preload lists. Jobs are queued up (as
+// files are read) and each thread claims the next one until the queue is
+// closed and empty. Every list is stored in its own handle, so the array's
+// order doesn't depend on which thread loaded it.
+typedef struct _TaskListPreloader
+{
+    TaskListPreloadJob* jobs;   // queued jobs (room for every list)
+    int count;                  // number of jobs queued so far
+    int next;                   // next job to claim
+    int closed;                 // set once no more jobs will be queued
+    int* batch_indexes;         // indexes of the lists being batch-read
+                                // (-1 once a list's file has been read)
+    pthread_mutex_t lock;       // protects everything above
+    pthread_cond_t queued;      // signaled when a job is queued (or closed)
+} TaskListPreloader;
+
 // Function prototypes
 void clean_up();
+void* tasklist_preload_worker(void* arg);
+void tasklist_preload_queue(TaskListPreloader* loader, int index, char* data,
+                            size_t length, struct stat* stats);
+void tasklist_preload_close(TaskListPreloader* loader);
+void tasklist_preload_file(int index, char* data, size_t length,
+                           struct stat* stats, void* arg);
+int tasklist_name_index_add(int index);
+int tasklist_name_index_build();
+int tasklist_handle_cmp(const void* a, const void* b);
+void tasklist_home_remember();
+int tasklist_home_changed();
 
 
 // ========================= Error/Exit Functions ========================== //
@@ -35,14 +86,33 @@ void fatality(int exit_code, char* message)
     else
     { eprintf("%s\n", message); }
 
-    // clean up and exit
+    // write out any changes that were waiting to be saved, so the commands
+    // that already succeeded aren't lost
+    if (task_list_saves_deferred())
+    {
+        defer_task_list_saves(0);
+        tasklist_array_save_dirty();
+    }
+
+    // if someone's ready to recover from the error, go back to them.
+    // Otherwise, clean up and exit
+    if (fatality_recovery_point)
+    { longjmp(*fatality_recovery_point, exit_code ? exit_code : 1); }
     clean_up();
     exit(exit_code);
 }
 
+void fatality_recover_at(jmp_buf* point)
+{ fatality_recovery_point = point; }
+
 void finish()
 {
-    // clean up memory and exit
+    // write out any changes that were waiting to be saved and bring the
+    // manifest up to date, then clean up memory and exit
+    defer_task_list_saves(0);
+    if (tasklist_array_save_dirty())
+    { eprintf("Failed to save every changed task list.\n"); }
+    tasklist_array_sync();
     clean_up();
     exit(0);
 }
@@ -95,7 +165,7 @@ void clean_up()
         free(commands);
     }
     // free the tasklist array
-    tasklist_array_free();
+    if (tasklists) { tasklist_array_free(); }
 }
 
 
@@ -121,7 +191,7 @@ void print_intro()
     // count those that actually have tasks
     int filled_amount = 0;
     for (int i = 0; i < tasklist_array_length; i++)
-    { filled_amount += tasklists[i]->size > 0; }
+    { filled_amount += tasklist_array_entry(i)->size > 0; }
     
     // print a message about only SOME being full
     if (tasklist_array_length > filled_amount)
@@ -139,20 +209,32 @@ void print_intro()
         { printf("Only %d contain tasks.\n", filled_amount); }
     }
 
-    // iterate and print each in box form
+    // every non-empty list is about to be drawn, so we'll load them all at
+    // once, in parallel
+    tasklist_array_preload(1);
+
+    // iterate and render each in box form, then write them all out at once
+    // (unless they're huge, in which case they're streamed out as they're
+    // drawn)
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { fatality(1, "Failed to allocate memory for output."); }
+    output_buffer_stream(out, STDOUT_FILENO);
     for (int i = 0; i < print_amount; i++)
     {
-        // only print if the list has tasks
-        if (tasklists[i]->size > 0)
+        // only print (and load) the list if it has tasks
+        if (tasklist_array_entry(i)->size > 0)
         {
-            BoxStack* bs = task_list_to_box_stack(tasklists[i], 1);
-            if (!bs)
-            { eprintf("Couldn't print task list: %s.\n", tasklists[i]->name); }
-
-            box_stack_print(bs);
-            box_stack_free(bs);
+            TaskList* list = tasklist_array_get(i);
+            if (task_list_render(list, 1, out))
+            {
+                // (flush what we have first, so the error shows up in order)
+                output_buffer_flush(out, STDOUT_FILENO);
+                eprintf("Couldn't print task list: %s.\n", list->name);
+            }
         }
     }
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
 }
 
 void print_logo(char* prefix)
@@ -160,42 +242,49 @@ void print_logo(char* prefix)
     // if we weren't given a prefix, use a blank string
     if (!prefix)
     { prefix = ""; }
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return; }
     
     // ========================== Row 1 ========================== //
     //            T1      T2               D
-    printf("%s  \u2588  \u2588        \u2588", prefix);
-    printf("\n");
+    output_printf(out, "%s  \u2588  \u2588        \u2588", prefix);
+    output_string(out, "\n");
     
     // ========================== Row 2 ========================== //
     //        ---------- T1 ------------- -------- T2 --------
-    printf("%s\u2580\u2580\u2588\u2580\u2580\u2588\u2580\u2580", prefix);
+    output_printf(out, "%s\u2580\u2580\u2588\u2580\u2580\u2588\u2580\u2580", prefix);
     //      ---- Y ----- ------ D ------- -------- O ---------
-    printf("\u2588  \u2588\u2580\u2580\u2588\u2580\u2580\u2588");
-    printf("\n");
+    output_string(out, "\u2588  \u2588\u2580\u2580\u2588\u2580\u2580\u2588");
+    output_string(out, "\n");
     
     // ========================== Row 3 ========================== //
     //            T1      T2    ---------- Y -----------
-    printf("%s  \u2588  \u2588  \u2588\u2584\u2584\u2588", prefix);
+    output_printf(out, "%s  \u2588  \u2588  \u2588\u2584\u2584\u2588", prefix);
     //      ------- D ------- ------- O --------
-    printf("\u2584\u2584\u2588\u2584\u2584\u2588");
-    printf("\n");
+    output_string(out, "\u2584\u2584\u2588\u2584\u2584\u2588");
+    output_string(out, "\n");
     
     // ========================== Row 4 ========================== //
     //          --------- underline ---------- ----- Y ------
-    printf("%s  \u2584\u2584\u2584\u2584\u2584 \u2584  \u2588", prefix);
+    output_printf(out, "%s  \u2584\u2584\u2584\u2584\u2584 \u2584  \u2588", prefix);
     //       --------- underline ----------
-    printf(" \u2584\u2584\u2584\u2584\u2584");
-    printf("\n");
+    output_string(out, " \u2584\u2584\u2584\u2584\u2584");
+    output_string(out, "\n");
 
     // ========================== Row 5 ========================== //
     //                ---------- Y -----------
-    printf("%s        \u2580\u2580\u2580\u2580", prefix);
-    printf("\n");
+    output_printf(out, "%s        \u2580\u2580\u2580\u2580", prefix);
+    output_string(out, "\n");
+
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
 }
 
 void print_box_terminal_safe(char* title, char* text)
 {
     int terminal_width = get_terminal_width();
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return; }
 
     // print title
     int top_line_chars_remaining = terminal_width;
@@ -205,27 +294,31 @@ void print_box_terminal_safe(char* title, char* text)
         if (title_length < terminal_width)
         { top_line_chars_remaining -= title_length + 2; }
 
-        printf("%s%s %s ", BOX_H_LINE, BOX_H_LINE, title);
+        output_printf(out, "%s%s %s ", BOX_H_LINE, BOX_H_LINE, title);
     }
     // print remainder of top line
-    for (int i = 0; i < top_line_chars_remaining; i++)
-    { printf("%s", BOX_H_LINE); }
+    output_repeat(out, BOX_H_LINE, top_line_chars_remaining);
 
     // print box text
     if (text)
-    { printf("\n%s\n", text); }
+    { output_printf(out, "\n%s\n", text); }
 
     // print bottom line and newline
-    for (int i = 0; i < terminal_width; i++)
-    { printf("%s", BOX_H_LINE); }
-    printf("\n");
+    output_repeat(out, BOX_H_LINE, terminal_width);
+    output_string(out, "\n");
+
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
 }
 
 void print_horizontal_line(int length)
 {
-    for (int i = 0; i < length; i++)
-    { printf(H_LINE); }
-    printf("\n");
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return; }
+    output_repeat(out, H_LINE, length);
+    output_string(out, "\n");
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
 }
 
 int print_subcommands(Command* comm, char* title)
@@ -271,7 +364,7 @@ int print_subcommands(Command* comm, char* title)
         }
 
         // update the maximum line length
-        int length = strlen(comm_string) + 1;
+        int length = display_width(comm_string, strlen(comm_string)) + 1;
         if (length > longest_length)
         { longest_length = length; }
 
@@ -323,14 +416,13 @@ void print_usage(char* usage)
 // ======================= Task List Array Functions ======================= //
 int tasklist_array_init()
 {
-    // first, count the number of task lists stored on disk in the ttydo
-    // directory. If there are more than our initial capacity, we'll want to
-    // allocate a larger array.
-    char** list_names = NULL;
-    int list_count = count_saved_task_lists(&list_names);
-
-    // sort the array of list names
-    sort_string_array((const char**) list_names, list_count);
+    // read the manifest to get a summary of every task list stored on disk in
+    // the ttydo directory (this also picks up any lists that were added or
+    // edited outside of ttydo). If there are more than our initial capacity,
+    // we'll want to allocate a larger array.
+    ManifestEntry* entries = NULL;
+    int list_count = manifest_load(&entries);
+    if (list_count < 0) { list_count = 0; }
 
     // calculate the nearest power of two relative to the list count
     int list_cap = 0;
@@ -350,21 +442,25 @@ int tasklist_array_init()
     tasklist_array_capacity = list_cap;
 
     // use the capacity to create an appropriately-size array
-    tasklists = calloc(tasklist_array_capacity, sizeof(TaskList*));
+    tasklists = calloc(tasklist_array_capacity, sizeof(TaskListHandle));
     if (!tasklists)
     { return 1; }
 
-    // iterate through the task list files and load them into memory
+    // create a handle for each manifest entry (they're already sorted). The
+    // lists themselves aren't loaded until a command asks for them (see
+    // 'tasklist_array_get'), so the handles take ownership of the entries
     for (int i = 0; i < list_count; i++)
     {
-        // load the file, increase the array length, and free the path string
-        tasklists[i] = load_task_list(list_names[i]);
+        tasklists[i].entry = entries[i];
+        tasklists[i].list = NULL;
         tasklist_array_length++;
-        free(list_names[i]);
     }
-    free(list_names);
+    if (entries) { free(entries); }
+    tasklist_home_remember();
 
-    return 0;
+    // index the lists by name, so they can be found without comparing the
+    // input against every name
+    return tasklist_name_index_build();
 }
 
 void tasklist_array_free()
@@ -373,14 +469,234 @@ void tasklist_array_free()
 
     if (tasklist_array_length > 0)
     {
-        // iterate up to tasklist_array_length times and free each tasklist
+        // iterate up to tasklist_array_length times and free each handle (and
+        // its tasklist, if it was loaded)
         for (int i = 0; i < tasklist_array_length; i++)
-        { task_list_free(tasklists[i]); }
+        {
+            manifest_entry_free_fields(&tasklists[i].entry);
+            task_list_free(tasklists[i].list);
+        }
     }
 
     // free the tasklist pointer itself and set it back to NULL
     free(tasklists);
     tasklists = NULL;
+    hash_index_free(tasklist_name_index);
+    tasklist_name_index = NULL;
+}
+
+int tasklist_array_sync()
+{
+    if (!tasklists) { return 1; }
+
+    // any list that was loaded may have been modified (and saved), so we'll
+    // refresh its entry, including its file's modification time
+    for (int i = 0; i < tasklist_array_length; i++)
+    {
+        if (tasklists[i].list &&
+            manifest_entry_update(&tasklists[i].entry, tasklists[i].list, 1))
+        { tasklist_manifest_dirty = 1; }
+    }
+    if (!tasklist_manifest_dirty)
+    {
+        tasklist_home_remember();
+        return 0;
+    }
+
+    // build an array of entry pointers and write them out
+    ManifestEntry** entries = calloc(tasklist_array_length + 1,
+                                     sizeof(ManifestEntry*));
+    if (!entries) { return 1; }
+    for (int i = 0; i < tasklist_array_length; i++)
+    { entries[i] = &tasklists[i].entry; }
+    int result = manifest_save(entries, tasklist_array_length);
+    free(entries);
+
+    tasklist_manifest_dirty = result != 0;
+    tasklist_home_remember();
+    return result;
+}
+
+int tasklist_array_refresh()
+{
+    if (!tasklists)
+    {
+        tasklist_array_length = 0;
+        return tasklist_array_init();
+    }
+
+    // creating, deleting, or renaming a list changes the home directory, and
+    // saving one (or journaling a change to it) changes its own files
+    int changed = tasklist_home_changed();
+    for (int i = 0; i < tasklist_array_length && !changed; i++)
+    { changed = manifest_entry_is_stale(&tasklists[i].entry); }
+    if (!changed)
+    {
+        // lists are loaded in order of their file names, but added (and
+        // renamed) lists are left where they were put
+        int sorted = 1;
+        for (int i = 1; i < tasklist_array_length && sorted; i++)
+        { sorted = tasklist_handle_cmp(&tasklists[i - 1], &tasklists[i]) <= 0; }
+        if (sorted) { return 0; }
+        qsort(tasklists, tasklist_array_length, sizeof(TaskListHandle),
+              tasklist_handle_cmp);
+        return tasklist_name_index_build();
+    }
+
+    // start over from the manifest, which picks up whatever changed
+    tasklist_array_free();
+    tasklist_array_length = 0;
+    return tasklist_array_init();
+}
+
+int tasklist_array_save_dirty()
+{
+    if (!tasklists) { return 1; }
+
+    // only loaded lists can have been changed
+    int failed = 0;
+    for (int i = 0; i < tasklist_array_length; i++)
+    {
+        if (tasklists[i].list && save_task_list_if_dirty(tasklists[i].list))
+        { failed = 1; }
+    }
+    return failed;
+}
+
+ManifestEntry* tasklist_array_entry(int index)
+{
+    // check our global list or invalid input
+    if (!tasklists) { fatality(1, "Task list array not initialized."); }
+    if (index < 0 || index >= tasklist_array_length)
+    { return NULL; }
+
+    // if the list is loaded, its in-memory state is the most recent, so we'll
+    // refresh the entry from it first
+    TaskListHandle* handle = &tasklists[index];
+    if (handle->list)
+    { manifest_entry_update(&handle->entry, handle->list, 0); }
+    return &handle->entry;
+}
+
+TaskList* tasklist_array_get(int index)
+{
+    // check our global list or invalid input
+    if (!tasklists) { fatality(1, "Task list array not initialized."); }
+    if (index < 0 || index >= tasklist_array_length)
+    { return NULL; }
+
+    // if the list has already been loaded, return it
+    TaskListHandle* handle = &tasklists[index];
+    if (handle->list)
+    { return handle->list; }
+
+    // otherwise, load it from disk now. A list that can't be read is treated
+    // as a fatal error, just like a failed write
+    handle->list = load_task_list(handle->entry.file_name);
+    if (!handle->list)
+    {
+        int message_max_length = TASK_LIST_NAME_MAX_LENGTH + 64;
+        char message[message_max_length];
+        snprintf(message, message_max_length,
+                 "Failed to load task list '%s' from disk.",
+                 handle->entry.file_name);
+        fatality(1, message);
+    }
+    return handle->list;
+}
+
+void tasklist_array_preload(int nonempty_only)
+{
+    if (!tasklists) { fatality(1, "Task list array not initialized."); }
+
+    // collect the indexes of the lists that need loading. (There may be
+    // thousands of them, so these arrays go on the heap. Preloading is only
+    // an optimization: if there isn't room, the lists are loaded one at a
+    // time as they're requested)
+    int* indexes = calloc(tasklist_array_length + 1, sizeof(int));
+    if (!indexes) { return; }
+    int count = 0;
+    for (int i = 0; i < tasklist_array_length; i++)
+    {
+        if (!tasklists[i].list &&
+            (!nonempty_only || tasklists[i].entry.size > 0))
+        { indexes[count++] = i; }
+    }
+    TaskListPreloader loader = {NULL, 0, 0, 0, indexes,
+                                PTHREAD_MUTEX_INITIALIZER,
+                                PTHREAD_COND_INITIALIZER};
+    loader.jobs = count > 0 ? calloc(count, sizeof(TaskListPreloadJob)) : NULL;
+    if (!loader.jobs)
+    {
+        free(indexes);
+        return;
+    }
+
+    // binary lists are mapped by the threads (which is cheaper than reading
+    // them), so they're queued up right away. The text lists are read in one
+    // batch, below
+    int batch_count = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (tasklists[indexes[i]].entry.format == TASK_LIST_FORMAT_BINARY)
+        { tasklist_preload_queue(&loader, indexes[i], NULL, 0, NULL); }
+        else
+        { indexes[batch_count++] = indexes[i]; }
+    }
+
+    // make sure the home directory's path is built before any threads start
+    get_home_directory();
+
+    // decide how many threads to use: one per core, but no more than there
+    // are lists (this thread counts as one of them)
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int thread_count = cores > 0 ? cores : 1;
+    if (thread_count > count) { thread_count = count; }
+    if (thread_count > TASKLIST_PRELOAD_MAX_THREADS)
+    { thread_count = TASKLIST_PRELOAD_MAX_THREADS; }
+
+    // start the other threads. (If a thread can't be started, the ones that
+    // did start will pick up its share)
+    pthread_t threads[TASKLIST_PRELOAD_MAX_THREADS];
+    int started = 0;
+    while (started < thread_count - 1 &&
+           !pthread_create(&threads[started], NULL, tasklist_preload_worker, &loader))
+    { started++; }
+
+    // read the text lists' files all at once (through io_uring). Each one is
+    // queued up as soon as it's read, so the threads parse them while the
+    // rest are still being read
+    char** paths = calloc(batch_count + 1, sizeof(char*));
+    int path_count = 0;
+    for (; paths && path_count < batch_count; path_count++)
+    {
+        paths[path_count] = make_task_list_file_path(
+                                tasklists[indexes[path_count]].entry.file_name);
+        if (!paths[path_count]) { break; }
+    }
+    if (paths && path_count == batch_count && batch_count > 0)
+    { file_batch_read(paths, batch_count, tasklist_preload_file, &loader); }
+    for (int i = 0; i < path_count; i++)
+    { free(paths[i]); }
+    free(paths);
+
+    // whatever wasn't read (everything, if the files couldn't be read in a
+    // batch) is loaded by the threads from scratch. Then, help them out
+    for (int i = 0; i < batch_count; i++)
+    {
+        if (indexes[i] >= 0)
+        { tasklist_preload_queue(&loader, indexes[i], NULL, 0, NULL); }
+    }
+    tasklist_preload_close(&loader);
+    tasklist_preload_worker(&loader);
+
+    // wait for the others to finish
+    for (int i = 0; i < started; i++)
+    { pthread_join(threads[i], NULL); }
+    pthread_cond_destroy(&loader.queued);
+    pthread_mutex_destroy(&loader.lock);
+    free(loader.jobs);
+    free(indexes);
 }
 
 int tasklist_array_add(TaskList* list)
@@ -394,16 +710,29 @@ int tasklist_array_add(TaskList* list)
     if (tasklist_array_length == tasklist_array_capacity)
     {
         tasklist_array_capacity <<= 1; // multiply by 2
-        tasklists = realloc(tasklists, tasklist_array_capacity * sizeof(TaskList*));
+        tasklists = realloc(tasklists, tasklist_array_capacity * sizeof(TaskListHandle));
         if (!tasklists)
         { fatality(1, "Task list array couldn't be expanded."); }
     }
 
+    // build a handle for the (already loaded) list
+    char* file_name = task_list_file_name(list->name);
+    if (!file_name) { return 1; }
+
     // add the task list to the next available index, save it to a file, and
     // return 0. (Exit on failed save attempt)
-    tasklists[tasklist_array_length++] = list;
+    TaskListHandle* handle = &tasklists[tasklist_array_length++];
+    memset(handle, 0, sizeof(TaskListHandle));
+    handle->entry.file_name = file_name;
+    handle->list = list;
     if (save_task_list(list))
     { fatality(1, "Failed to write to task list to disk."); }
+
+    // build the list's manifest entry and index its name
+    manifest_entry_update(&handle->entry, list, 1);
+    tasklist_manifest_dirty = 1;
+    if (tasklist_name_index_add(tasklist_array_length - 1))
+    { fatality(1, "Task list name index couldn't be expanded."); }
     return 0;
 }
 
@@ -414,32 +743,100 @@ int tasklist_array_remove(int index)
     if (index < 0 || index >= tasklist_array_length)
     { return 1; }
 
-    // delete the task list's file on disk
-    int del_result = delete_task_list(tasklists[index]);
+    // delete the task list's file on disk (this only needs the list's name,
+    // so there's no point in loading its tasks first)
+    TaskList* list = tasklists[index].list;
+    if (!list)
+    { list = task_list_new(tasklists[index].entry.name); }
+    int del_result = delete_task_list(list);
+    if (!tasklists[index].list)
+    { task_list_free(list); }
     if (del_result)
     {
         eprintf("Failed to delete task list from disk.\n");
         return 1;
     }
     
-    // free and null-out the pointer
-    task_list_free(tasklists[index]);
-    tasklists[index] = NULL;
+    // free and null-out the handle
+    manifest_entry_free_fields(&tasklists[index].entry);
+    task_list_free(tasklists[index].list);
+    tasklists[index].list = NULL;
+    tasklist_manifest_dirty = 1;
 
     // if the are task lists that occurr after the one we just removed, we
     // need to shift them down
     if (index < tasklist_array_length - 1)
     {
-        for (int i = index; i < tasklist_array_length; i++)
+        for (int i = index; i < tasklist_array_length - 1; i++)
         { tasklists[i] = tasklists[i + 1]; }
     }
 
-    // decrease the array size
+    // decrease the array size. Every list after the removed one has a new
+    // index, so the name index is rebuilt
     tasklist_array_length--;
+    if (tasklist_name_index_build())
+    { fatality(1, "Task list name index couldn't be rebuilt."); }
 
     return 0;
 }
 
+int tasklist_array_rename(int index, char* name)
+{
+    // check our global list or invalid input
+    if (!tasklists) { fatality(1, "Task list array not initialized."); }
+    if (index < 0 || index >= tasklist_array_length || !name)
+    { return 1; }
+    TaskList* list = tasklist_array_get(index);
+
+    // build the new file name and name before touching anything on disk
+    char* file_name = task_list_file_name(name);
+    char* new_name = strdup(name);
+    if (!file_name || !new_name)
+    {
+        free(file_name);
+        free(new_name);
+        return 1;
+    }
+
+    // write the list out under its new name first, and only then delete its
+    // old file, so it's always on disk under one name or the other. (This
+    // happens right away, even if saves are deferred: otherwise the old file
+    // would be gone long before the new one was written)
+    char* old_name = list->name;
+    list->name = new_name;
+    list->dirty = 1;
+    int result = save_task_list_if_dirty(list);
+    if (result)
+    {
+        eprintf("Failed to write the renamed list to disk.\n");
+        list->name = old_name;
+        free(new_name);
+        free(file_name);
+        return result;
+    }
+    if (strcmp(tasklists[index].entry.file_name, file_name))
+    {
+        TaskList* old_list = task_list_new(old_name);
+        if (!old_list || delete_task_list(old_list))
+        { eprintf("Couldn't delete old list file.\n"); }
+        task_list_free(old_list);
+    }
+    free(old_name);
+    free(tasklists[index].entry.file_name);
+    tasklists[index].entry.file_name = file_name;
+
+    // update the list's manifest entry, and move it to its new name's spot in
+    // the name index
+    hash_index_remove(tasklist_name_index,
+                      hash_index_string(tasklists[index].entry.name),
+                      (void*) (intptr_t) (index + 1));
+    manifest_entry_update(&tasklists[index].entry, list, 1);
+    tasklist_manifest_dirty = 1;
+    if (tasklist_name_index_add(index))
+    { fatality(1, "Task list name index couldn't be expanded."); }
+    return result;
+}
+
 int tasklist_array_find(char* input)
 {
     // check for null input
@@ -450,17 +847,27 @@ int tasklist_array_find(char* input)
     long index = strtol(input, &end, 10);
 
     // if the index is zero, we'll assume parsing failed, and we'll try
-    // to find the index by interpreting the argument as a task list name
-    int temp = 0;
-    while (temp < tasklist_array_length && index == 0)
+    // to find the index by interpreting the argument as a task list name.
+    // Only the lists stored under the name's hash need to be compared. (Names
+    // come from the manifest entries, so no lists are loaded here)
+    if (index == 0)
     {
-        // compare at most TASK_LIST_NAME_MAX_LENGTH characters. If the
-        // current list matches the name, 
-        if (!strncmp(tasklists[temp]->name, input,
-            TASK_LIST_NAME_MAX_LENGTH))
-        { index = temp + 1; }
-        // increment temporary index
-        temp++;
+        // names are compared on at most TASK_LIST_NAME_MAX_LENGTH characters,
+        // so only that many are hashed
+        char name[TASK_LIST_NAME_MAX_LENGTH + 1];
+        snprintf(name, TASK_LIST_NAME_MAX_LENGTH + 1, "%s", input);
+        uint64_t hash = hash_index_string(name);
+        size_t position = 0;
+        void* value;
+        while ((value = hash_index_next(tasklist_name_index, hash, &position)))
+        {
+            // if more than one list has the name, the first one wins
+            long temp = (intptr_t) value;
+            if (!strncmp(tasklist_array_entry(temp - 1)->name, name,
+                         TASK_LIST_NAME_MAX_LENGTH) &&
+                (index == 0 || temp < index))
+            { index = temp; }
+        }
     }
 
     // if we didn't find an index, print and continue
@@ -471,6 +878,140 @@ int tasklist_array_find(char* input)
     return index - 1;
 }
 
+// The function run by each preloading thread: it repeatedly claims the next
+// queued list and loads it, until the queue is closed and empty.
+void* tasklist_preload_worker(void* arg)
+{
+    TaskListPreloader* loader = arg;
+    while (1)
+    {
+        // wait for a job (or for the queue to be closed)
+        pthread_mutex_lock(&loader->lock);
+        while (loader->next >= loader->count && !loader->closed)
+        { pthread_cond_wait(&loader->queued, &loader->lock); }
+        if (loader->next >= loader->count)
+        {
+            pthread_mutex_unlock(&loader->lock);
+            break;
+        }
+        TaskListPreloadJob job = loader->jobs[loader->next++];
+        pthread_mutex_unlock(&loader->lock);
+
+        // parse the file's contents if they were read, or load it otherwise
+        TaskListHandle* handle = &tasklists[job.index];
+        if (job.data)
+        {
+            handle->list = load_task_list_from_buffer(handle->entry.file_name,
+                                                      job.data, job.length,
+                                                      &job.stats);
+            free(job.data);
+        }
+        else
+        { handle->list = load_task_list(handle->entry.file_name); }
+    }
+    return NULL;
+}
+
+// Queues up the list at the given index of the global array for a preloading
+// thread to load, along with its file's contents and stats (if they've been
+// read, in which case the thread takes over 'data').
+void tasklist_preload_queue(TaskListPreloader* loader, int index, char* data,
+                            size_t length, struct stat* stats)
+{
+    pthread_mutex_lock(&loader->lock);
+    TaskListPreloadJob* job = &loader->jobs[loader->count++];
+    job->index = index;
+    job->data = data;
+    job->length = length;
+    if (stats) { job->stats = *stats; }
+    pthread_cond_signal(&loader->queued);
+    pthread_mutex_unlock(&loader->lock);
+}
+
+// Tells the preloading threads that no more lists will be queued, so they
+// stop once the queue is empty.
+void tasklist_preload_close(TaskListPreloader* loader)
+{
+    pthread_mutex_lock(&loader->lock);
+    loader->closed = 1;
+    pthread_cond_broadcast(&loader->queued);
+    pthread_mutex_unlock(&loader->lock);
+}
+
+// Called by the batch reader for each text list file it reads (on this
+// thread): the contents are queued up for a preloading thread to parse. 'arg'
+// is the preloader.
+void tasklist_preload_file(int index, char* data, size_t length,
+                           struct stat* stats, void* arg)
+{
+    TaskListPreloader* loader = arg;
+    int list_index = loader->batch_indexes[index];
+    loader->batch_indexes[index] = -1;
+
+    // if the file was replaced by a binary one since the manifest was
+    // checked, it's mapped instead (the contents can't be parsed as text)
+    if (taskbin_is_binary(data, length))
+    {
+        free(data);
+        data = NULL;
+    }
+    tasklist_preload_queue(loader, list_index, data, length, stats);
+}
+
+// Adds the list at the given index of the global array to the name index.
+// Returns 0 on success and a non-zero value on failure.
+int tasklist_name_index_add(int index)
+{
+    // the index is stored plus one, since the hash index can't hold NULL
+    char* name = tasklists[index].entry.name;
+    return hash_index_add(tasklist_name_index, hash_index_string(name),
+                          (void*) (intptr_t) (index + 1));
+}
+
+// Compares two task list handles by their file names (the order in which
+// lists are loaded).
+int tasklist_handle_cmp(const void* a, const void* b)
+{
+    return strcmp(((TaskListHandle*) a)->entry.file_name,
+                  ((TaskListHandle*) b)->entry.file_name);
+}
+
+// Saves the home directory's modification time, so 'tasklist_home_changed'
+// can tell whether lists have been created, deleted, or renamed since.
+void tasklist_home_remember()
+{
+    struct stat stats;
+    char* home = get_home_directory();
+    if (!home || stat(home, &stats)) { memset(&stats, 0, sizeof(struct stat)); }
+    tasklist_home_mtime = stats.st_mtim;
+}
+
+// Returns non-zero if the home directory's modification time has changed
+// since it was last remembered (or it can't be found).
+int tasklist_home_changed()
+{
+    struct stat stats;
+    char* home = get_home_directory();
+    if (!home || stat(home, &stats)) { return 1; }
+    return stats.st_mtim.tv_sec != tasklist_home_mtime.tv_sec ||
+           stats.st_mtim.tv_nsec != tasklist_home_mtime.tv_nsec;
+}
+
+// (Re)builds the name index from every list in the global array. Returns 0 on
+// success and a non-zero value on failure.
+int tasklist_name_index_build()
+{
+    hash_index_free(tasklist_name_index);
+    tasklist_name_index = hash_index_new();
+    if (!tasklist_name_index) { return 1; }
+    for (int i = 0; i < tasklist_array_length; i++)
+    {
+        if (tasklist_name_index_add(i)) { return 1; }
+    }
+    return 0;
+}
+
+
 // ======================== Other Helper Functions ========================= //
 void sort_string_array(const char** strings, int length)
 {
@@ -493,8 +1034,10 @@ void replace_string_non_printables(char* string, int max_length)
     char* current = string;
     while (i < max_length && current)
     {
+        // (bytes are compared unsigned, so UTF-8 characters are kept)
         if (*current == '\n' || *current == '\t' || *current == '\r' ||
-            *current == '\v' || (int) *current < 32)
+            *current == '\v' || (unsigned char) *current < 32 ||
+            *current == 127)
         { *current = ' '; }
 
         i++;
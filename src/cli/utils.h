@@ -6,14 +6,29 @@
 #define UTILS_H
 
 // Module inclusions
+#include <setjmp.h>
 #include "command.h"
 #include "../visual/box.h"
 #include "../tasklist.h"
+#include "../manifest.h"
 
 // ================================ Macros ================================= //
 #define H_LINE "\u2500" // used for various prints in the CLI
 
 
+// ========================== Task List Handle ============================= //
+// The 'TaskListHandle' struct is a cheap stand-in for a task list saved on
+// disk. The global task list array holds one of these for every list, and the
+// list's body isn't parsed until it's first requested (via
+// 'tasklist_array_get'). Until then, the list's manifest entry answers
+// questions about its name, size, and completion count.
+typedef struct _TaskListHandle
+{
+    ManifestEntry entry; // the list's cached summary (see manifest.h)
+    TaskList* list;      // the loaded task list (NULL until it's requested)
+} TaskListHandle;
+
+
 // ========================= Error/Exit Functions ========================== //
 // Helper function that is used to print an error message to stderr, then exit
 // the program, due to some internal "fatal" error. If no message is provided,
@@ -21,6 +36,12 @@
 // program.
 void fatality(int exit_code, char* message);
 
+// Makes 'fatality' jump back to the given point (with 'longjmp', which
+// returns the exit code) instead of exiting, so a long-running process (such
+// as the daemon) can survive a single command failing. Passing NULL makes it
+// exit again.
+void fatality_recover_at(jmp_buf* point);
+
 // Standard, run-of-the-mill "exit and clean up" function.
 void finish();
 
@@ -64,13 +85,52 @@ void print_usage(char* usage);
 
 
 // ======================= Task List Array Functions ======================= //
-// Initializes an array of TaskList* pointers and saves it to the global
-// task list array. Returns 0 on success, and a non-zero value on failure.
+// Initializes an array of TaskListHandle structs (one for each list saved on
+// disk, as recorded by the manifest) and saves it to the global task list
+// array. No lists are loaded here. Returns 0 on success, and a non-zero value
+// on failure.
 int tasklist_array_init();
 
 // Frees the memory associated with the task list array.
 void tasklist_array_free();
 
+// Brings the manifest entry of every loaded task list up to date and, if
+// anything changed, writes the manifest out to disk. Returns 0 on success and
+// a non-zero value on failure.
+int tasklist_array_sync();
+
+// Checks whether any task list has changed on disk since the array was
+// initialized (or last synced), such as by another ttydo process or an
+// editor. If one has (or if the array isn't initialized, because an earlier
+// refresh failed), the array is rebuilt from the manifest (and its lists
+// are loaded again as they're requested). Otherwise, lists that were added
+// or renamed are moved back into the order they'd be loaded in, so each list
+// is numbered the same as it would be by a fresh ttydo process.
+// Returns 0 on success and a non-zero value on failure.
+int tasklist_array_refresh();
+
+// Writes out every loaded task list with changes that haven't been saved yet
+// (because saves were deferred; see scribe.h). Returns 0 on success and a
+// non-zero value if any list couldn't be saved.
+int tasklist_array_save_dirty();
+
+// Takes in an index into the global array and returns the list's manifest
+// entry (its name, size, completion count, and color) without loading the
+// list. Returns NULL if the index is invalid.
+ManifestEntry* tasklist_array_entry(int index);
+
+// Takes in an index into the global array and returns the TaskList stored
+// there. If the list hasn't been loaded from disk yet, it's loaded first.
+// Returns NULL if the index is invalid.
+TaskList* tasklist_array_get(int index);
+
+// Loads every task list in the global array that hasn't been loaded yet (or,
+// if 'nonempty_only' is non-zero, only the ones whose manifest entries say
+// they hold tasks). The files are spread across a pool of threads, one per
+// CPU core. Lists that fail to load are left unloaded, so 'tasklist_array_get'
+// reports the error when they're requested.
+void tasklist_array_preload(int nonempty_only);
+
 // Takes in a TaskList pointer and attempts to add it to the global array.
 // Returns 0 on success and a non-zero value on failure.
 int tasklist_array_add(TaskList* list);
@@ -80,6 +140,11 @@ int tasklist_array_add(TaskList* list);
 // Returns 0 on success and a non-zero value on error.
 int tasklist_array_remove(int index);
 
+// Takes in an index into the global array and a new name, and attempts to
+// rename the task list (moving its file on disk). Returns 0 on success and a
+// non-zero value on error.
+int tasklist_array_rename(int index, char* name);
+
 // Takes in a string input from the command-line and attempts to interpret it
 // as either a number or the name of a task list. In either case, the index
 // of the matching list is returned, or -1 if it can't be found.
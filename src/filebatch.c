@@ -0,0 +1,344 @@
+// This module implements filebatch.h's definitions. The ring is driven with
+// raw system calls (rather than through liburing), so there's nothing extra
+// to install or link against.
+//
+//      Connor Shugg
+
+// Module inclusions
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "filebatch.h"
+
+#ifdef __linux__
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <linux/io_uring.h>
+
+// =============== Constants and Helper Function Prototypes ================ //
+// Every operation's user data holds the index of its file, along with which
+// step of reading the file it is
+#define FILE_BATCH_OPEN 0
+#define FILE_BATCH_STAT 1
+#define FILE_BATCH_READ 2
+#define FILE_BATCH_DATA(index, step) ((((uint64_t) (index)) << 2) | (step))
+#define FILE_BATCH_MAX_READ (1 << 30) // most bytes asked for in a single read
+
+// The submission and completion queues, shared with the kernel.
+typedef struct _FileBatchRing
+{
+    int fd;                         // the ring's file descriptor
+    void* rings;                    // both queues' rings (mapped together)
+    size_t rings_size;              // size of the rings' mapping
+    struct io_uring_sqe* sqes;      // submission queue entries
+    size_t sqes_size;               // size of the entries' mapping
+    unsigned* sq_tail;              // submission queue's tail (we write it)
+    unsigned* sq_mask;              // mask applied to submission indexes
+    unsigned* sq_array;             // indexes of submitted entries
+    unsigned* cq_head;              // completion queue's head (we write it)
+    unsigned* cq_tail;              // completion queue's tail
+    unsigned* cq_mask;              // mask applied to completion indexes
+    struct io_uring_cqe* cqes;      // completion queue entries
+    unsigned entries;               // number of submission queue entries
+    unsigned queued;                // entries queued but not yet submitted
+} FileBatchRing;
+
+// The progress made on reading a single file.
+typedef struct _FileBatchFile
+{
+    int fd;                         // the open file (or -1)
+    struct statx stx;               // the file's stats
+    char* data;                     // buffer holding the file's contents
+    size_t size;                    // the file's size
+    size_t length;                  // number of bytes read so far
+} FileBatchFile;
+
+int file_batch_ring_init(FileBatchRing* ring, unsigned entries);
+void file_batch_ring_free(FileBatchRing* ring);
+struct io_uring_sqe* file_batch_ring_queue(FileBatchRing* ring);
+int file_batch_step(FileBatchRing* ring, FileBatchFile* files,
+                    struct io_uring_cqe* cqe, FileBatchCallback callback,
+                    void* arg);
+void file_batch_finish(FileBatchFile* file, int index, int success,
+                       FileBatchCallback callback, void* arg);
+
+
+// ============================ Batch Functions ============================ //
+int file_batch_read(char** paths, int count, FileBatchCallback callback,
+                    void* arg)
+{
+    if (!paths || count <= 0 || !callback) { return 0; }
+
+    // set up the ring (no bigger than it needs to be)
+    FileBatchRing ring;
+    if (file_batch_ring_init(&ring, count < FILE_BATCH_RING_ENTRIES ?
+                                    count : FILE_BATCH_RING_ENTRIES))
+    { return 1; }
+    FileBatchFile* files = calloc(count, sizeof(FileBatchFile));
+    if (!files)
+    {
+        file_batch_ring_free(&ring);
+        return 1;
+    }
+    for (int i = 0; i < count; i++)
+    { files[i].fd = -1; }
+
+    // every file is opened, then stat'd, then read. Each finished operation
+    // queues at most one more, so keeping no more operations in flight than
+    // the ring has entries means it never fills up
+    int next_open = 0;
+    unsigned in_flight = 0;
+    while (next_open < count || in_flight > 0)
+    {
+        // queue up opens for as many files as there's room for
+        while (next_open < count && in_flight < ring.entries)
+        {
+            struct io_uring_sqe* sqe = file_batch_ring_queue(&ring);
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uintptr_t) paths[next_open];
+            sqe->open_flags = O_RDONLY | O_CLOEXEC;
+            sqe->user_data = FILE_BATCH_DATA(next_open, FILE_BATCH_OPEN);
+            next_open++;
+            in_flight++;
+        }
+
+        // submit everything that's queued, and wait for something to finish
+        int result = syscall(__NR_io_uring_enter, ring.fd, ring.queued, 1,
+                             IORING_ENTER_GETEVENTS, NULL, 0);
+        if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        { break; }
+        if (result > 0) { ring.queued -= result; }
+
+        // handle every finished operation
+        unsigned head = *ring.cq_head;
+        while (head != __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE))
+        {
+            struct io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+            in_flight--;
+            in_flight += file_batch_step(&ring, files, cqe, callback, arg);
+            head++;
+            __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    // if the ring broke down early, the kernel may still be writing into some
+    // of the buffers, so they're left alone. Otherwise, everything's finished
+    for (int i = 0; i < count; i++)
+    {
+        if (files[i].fd >= 0) { close(files[i].fd); }
+        if (in_flight == 0) { free(files[i].data); }
+    }
+    free(files);
+    file_batch_ring_free(&ring);
+    return 0;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Sets up a ring with (at least) the given number of entries, and makes sure
+// the kernel supports every operation we need. Returns 0 on success and a
+// non-zero value on failure.
+int file_batch_ring_init(FileBatchRing* ring, unsigned entries)
+{
+    memset(ring, 0, sizeof(FileBatchRing));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(struct io_uring_params));
+    ring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) { return 1; }
+    ring->rings = MAP_FAILED;
+    ring->sqes = MAP_FAILED;
+
+    // ask the kernel which operations it supports (kernels too old to answer
+    // are too old to support them)
+    size_t probe_size = sizeof(struct io_uring_probe) +
+                        (256 * sizeof(struct io_uring_probe_op));
+    struct io_uring_probe* probe = calloc(1, probe_size);
+    int supported = probe &&
+        !syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE,
+                 probe, 256) &&
+        probe->last_op >= IORING_OP_READ &&
+        (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) &&
+        (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED) &&
+        (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+        (params.features & IORING_FEAT_SINGLE_MMAP);
+    free(probe);
+    if (!supported)
+    {
+        file_batch_ring_free(ring);
+        return 1;
+    }
+
+    // map both queues' rings (which share a mapping), then the entries
+    size_t sq_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    size_t cq_size = params.cq_off.cqes +
+                     (params.cq_entries * sizeof(struct io_uring_cqe));
+    ring->rings_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->rings = mmap(NULL, ring->rings_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->rings == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+        file_batch_ring_free(ring);
+        return 1;
+    }
+
+    // find each field inside the rings
+    char* rings = ring->rings;
+    ring->sq_tail = (unsigned*) (rings + params.sq_off.tail);
+    ring->sq_mask = (unsigned*) (rings + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*) (rings + params.sq_off.array);
+    ring->cq_head = (unsigned*) (rings + params.cq_off.head);
+    ring->cq_tail = (unsigned*) (rings + params.cq_off.tail);
+    ring->cq_mask = (unsigned*) (rings + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*) (rings + params.cq_off.cqes);
+    ring->entries = params.sq_entries;
+    return 0;
+}
+
+// Unmaps the ring's queues and closes it.
+void file_batch_ring_free(FileBatchRing* ring)
+{
+    if (ring->sqes != MAP_FAILED && ring->sqes)
+    { munmap(ring->sqes, ring->sqes_size); }
+    if (ring->rings != MAP_FAILED && ring->rings)
+    { munmap(ring->rings, ring->rings_size); }
+    close(ring->fd);
+}
+
+// Claims the next submission queue entry, clears it, and queues it up to be
+// submitted. The caller fills it in.
+struct io_uring_sqe* file_batch_ring_queue(FileBatchRing* ring)
+{
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->queued++;
+    return sqe;
+}
+
+// Takes in a finished operation and moves its file on to the next step
+// (queueing up another operation, if needed). Returns the number of
+// operations queued (zero or one).
+int file_batch_step(FileBatchRing* ring, FileBatchFile* files,
+                    struct io_uring_cqe* cqe, FileBatchCallback callback,
+                    void* arg)
+{
+    int index = cqe->user_data >> 2;
+    int step = cqe->user_data & 3;
+    FileBatchFile* file = &files[index];
+    if (cqe->res < 0)
+    {
+        file_batch_finish(file, index, 0, callback, arg);
+        return 0;
+    }
+
+    struct io_uring_sqe* sqe = NULL;
+    if (step == FILE_BATCH_OPEN)
+    {
+        // the file's open: stat it (through its descriptor, so the stats
+        // match the file we'll read, even if it's replaced in the meantime)
+        file->fd = cqe->res;
+        sqe = file_batch_ring_queue(ring);
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = file->fd;
+        sqe->addr = (uintptr_t) "";
+        sqe->len = STATX_BASIC_STATS;
+        sqe->off = (uintptr_t) &file->stx;
+        sqe->statx_flags = AT_EMPTY_PATH;
+        sqe->user_data = FILE_BATCH_DATA(index, FILE_BATCH_STAT);
+        return 1;
+    }
+
+    if (step == FILE_BATCH_STAT)
+    {
+        // now that we know its size, make room for its contents
+        file->size = file->stx.stx_size;
+        file->data = malloc(file->size + 1);
+        if (!file->data || file->size == 0)
+        {
+            file_batch_finish(file, index, file->data != NULL, callback, arg);
+            return 0;
+        }
+    }
+    else
+    {
+        // a read finished. If the file ended early (it shrank after it was
+        // stat'd), take what we got
+        file->length += cqe->res;
+        if (cqe->res == 0 || file->length >= file->size)
+        {
+            file_batch_finish(file, index, 1, callback, arg);
+            return 0;
+        }
+    }
+
+    // read (the rest of) the file
+    size_t remaining = file->size - file->length;
+    sqe = file_batch_ring_queue(ring);
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = file->fd;
+    sqe->addr = (uintptr_t) (file->data + file->length);
+    sqe->len = remaining < FILE_BATCH_MAX_READ ? remaining : FILE_BATCH_MAX_READ;
+    sqe->off = file->length;
+    sqe->user_data = FILE_BATCH_DATA(index, FILE_BATCH_READ);
+    return 1;
+}
+
+// Takes in a file that's done being read (successfully or not). If it was read,
+// its contents and stats are passed to the callback (which takes over the
+// buffer). Otherwise, its buffer is freed. Either way, the file is closed.
+void file_batch_finish(FileBatchFile* file, int index, int success,
+                       FileBatchCallback callback, void* arg)
+{
+    if (success)
+    {
+        // convert the file's stats into the usual struct
+        struct stat stats;
+        memset(&stats, 0, sizeof(struct stat));
+        stats.st_dev = makedev(file->stx.stx_dev_major, file->stx.stx_dev_minor);
+        stats.st_ino = file->stx.stx_ino;
+        stats.st_mode = file->stx.stx_mode;
+        stats.st_nlink = file->stx.stx_nlink;
+        stats.st_uid = file->stx.stx_uid;
+        stats.st_gid = file->stx.stx_gid;
+        stats.st_size = file->stx.stx_size;
+        stats.st_atim.tv_sec = file->stx.stx_atime.tv_sec;
+        stats.st_atim.tv_nsec = file->stx.stx_atime.tv_nsec;
+        stats.st_mtim.tv_sec = file->stx.stx_mtime.tv_sec;
+        stats.st_mtim.tv_nsec = file->stx.stx_mtime.tv_nsec;
+        stats.st_ctim.tv_sec = file->stx.stx_ctime.tv_sec;
+        stats.st_ctim.tv_nsec = file->stx.stx_ctime.tv_nsec;
+
+        file->data[file->length] = '\0';
+        callback(index, file->data, file->length, &stats, arg);
+        file->data = NULL;
+    }
+
+    free(file->data);
+    file->data = NULL;
+    if (file->fd >= 0) { close(file->fd); }
+    file->fd = -1;
+}
+
+#else
+
+// ============================ Batch Functions ============================ //
+int file_batch_read(char** paths, int count, FileBatchCallback callback,
+                    void* arg)
+{
+    // io_uring is only available on Linux
+    return 1;
+}
+
+#endif
@@ -0,0 +1,37 @@
+// This header file defines a batch file reader. It reads the entire contents
+// of many files at once through io_uring: the opens, stats, and reads for every
+// file are queued up together and handed to the kernel in a few system calls,
+// and each file is passed to a callback as soon as it's been read. It's used
+// to load every task list at startup without waiting on each file in turn.
+//
+//      Connor Shugg
+
+#ifndef FILEBATCH_H
+#define FILEBATCH_H
+
+// Module inclusions
+#include <stddef.h>
+#include <sys/stat.h>
+
+// ========================= Constants and Macros ========================== //
+#define FILE_BATCH_RING_ENTRIES 64      // most operations in flight at once
+
+
+// ============================ Batch Functions ============================ //
+// Called once for each file that was read in full, in whatever order they
+// finish. 'index' is the file's index in the array of paths, 'data' holds its
+// contents (null-terminated, and dynamically allocated: the callback takes it
+// over, and has to free it), and 'stats' holds its stats. 'arg' is passed
+// through from 'file_batch_read'.
+typedef void (*FileBatchCallback)(int index, char* data, size_t length,
+                                  struct stat* stats, void* arg);
+
+// Takes in an array of 'count' file paths and reads every one of them,
+// calling 'callback' for each file that's read. Files that can't be opened or
+// read are skipped. Returns 0 if the files were read, or a non-zero value if
+// the kernel doesn't support io_uring (in which case nothing was read, and the
+// caller should read the files itself).
+int file_batch_read(char** paths, int count, FileBatchCallback callback,
+                    void* arg);
+
+#endif
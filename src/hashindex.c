@@ -0,0 +1,148 @@
+// This module implements hashindex.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include "hashindex.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+// Removed values leave this behind in their slot, so probing doesn't stop
+// early at a gap (it only points at itself, and is never handed back)
+static char hash_index_removed;
+#define HASH_INDEX_REMOVED ((void*) &hash_index_removed)
+
+int hash_index_resize(HashIndex* index, size_t capacity);
+
+
+// =========================== Hash Index Struct =========================== //
+HashIndex* hash_index_new()
+{
+    return calloc(1, sizeof(HashIndex));
+}
+
+void hash_index_free(HashIndex* index)
+{
+    if (!index) { return; }
+    free(index->slots);
+    free(index);
+}
+
+int hash_index_add(HashIndex* index, uint64_t hash, void* value)
+{
+    if (!index || !value) { return 1; }
+
+    // if adding another value would fill the index past its maximum load,
+    // resize it first (to twice the values it holds, which also clears out
+    // any slots left behind by removed values)
+    if ((index->used + 1) * 100 > index->capacity * HASH_INDEX_MAX_LOAD)
+    {
+        size_t capacity = HASH_INDEX_MIN_CAPACITY;
+        while ((index->count + 1) * 2 * 100 > capacity * HASH_INDEX_MAX_LOAD)
+        { capacity *= 2; }
+        if (hash_index_resize(index, capacity)) { return 1; }
+    }
+
+    // probe for the first slot that isn't holding a value
+    size_t mask = index->capacity - 1;
+    size_t i = hash & mask;
+    while (index->slots[i].value && index->slots[i].value != HASH_INDEX_REMOVED)
+    { i = (i + 1) & mask; }
+
+    index->used += index->slots[i].value == NULL;
+    index->slots[i].hash = hash;
+    index->slots[i].value = value;
+    index->count++;
+    return 0;
+}
+
+int hash_index_remove(HashIndex* index, uint64_t hash, void* value)
+{
+    if (!index || !value || index->capacity == 0) { return 1; }
+
+    // probe until the value is found, or an empty slot is reached
+    size_t mask = index->capacity - 1;
+    size_t i = hash & mask;
+    for (size_t probes = 0; probes < index->capacity && index->slots[i].value;
+         probes++)
+    {
+        if (index->slots[i].value == value && index->slots[i].hash == hash)
+        {
+            index->slots[i].value = HASH_INDEX_REMOVED;
+            index->count--;
+            return 0;
+        }
+        i = (i + 1) & mask;
+    }
+    return 1;
+}
+
+void* hash_index_next(HashIndex* index, uint64_t hash, size_t* position)
+{
+    if (!index || !position || index->capacity == 0) { return NULL; }
+
+    // pick up probing where the last call left off
+    size_t mask = index->capacity - 1;
+    while (*position < index->capacity)
+    {
+        HashIndexSlot* slot = &index->slots[(hash + *position) & mask];
+        (*position)++;
+        if (!slot->value) { return NULL; }
+        if (slot->value != HASH_INDEX_REMOVED && slot->hash == hash)
+        { return slot->value; }
+    }
+    return NULL;
+}
+
+
+// ============================ Hash Functions ============================= //
+uint64_t hash_index_string(char* string)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325;
+    while (string && *string)
+    {
+        hash ^= (unsigned char) *string++;
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+uint64_t hash_index_integer(uint64_t value)
+{
+    // splitmix64's finalizer (task IDs are often sequential, so their bits
+    // need to be mixed before they're masked down to a slot)
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111eb;
+    value ^= value >> 31;
+    return value;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Moves every value in the index into a new array of slots with the given
+// capacity (a power of two). Returns 0 on success and non-zero on failure.
+int hash_index_resize(HashIndex* index, size_t capacity)
+{
+    HashIndexSlot* slots = calloc(capacity, sizeof(HashIndexSlot));
+    if (!slots) { return 1; }
+
+    // re-insert every value (slots left behind by removed values are dropped)
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < index->capacity; i++)
+    {
+        HashIndexSlot* slot = &index->slots[i];
+        if (!slot->value || slot->value == HASH_INDEX_REMOVED) { continue; }
+        size_t j = slot->hash & mask;
+        while (slots[j].value) { j = (j + 1) & mask; }
+        slots[j] = *slot;
+    }
+
+    free(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    index->used = index->count;
+    return 0;
+}
@@ -0,0 +1,67 @@
+// This header file defines the HashIndex: an open-addressing hash table that
+// maps 64-bit hashes to pointers. It doesn't know anything about the keys that
+// were hashed, so more than one value may share a hash - lookups hand back
+// every value stored under a hash, and it's up to the caller to compare the
+// real keys. TaskLists use it to find tasks by title and by ID.
+//
+//      Connor Shugg
+
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+// Module inclusions
+#include <stddef.h>
+#include <inttypes.h>
+
+// ========================= Constants and Macros ========================== //
+#define HASH_INDEX_MIN_CAPACITY 16      // smallest number of slots
+#define HASH_INDEX_MAX_LOAD 70          // max percentage of slots in use
+
+
+// =========================== Hash Index Struct =========================== //
+// A single slot in the index. Empty slots have a NULL value.
+typedef struct _HashIndexSlot
+{
+    uint64_t hash;                  // hash of the value's key
+    void* value;                    // the value itself
+} HashIndexSlot;
+
+// The 'HashIndex' struct holds the slots, which are probed linearly.
+typedef struct _HashIndex
+{
+    HashIndexSlot* slots;           // array of slots (a power of two of them)
+    size_t capacity;                // number of slots
+    size_t count;                   // number of values stored
+    size_t used;                    // number of non-empty slots (including
+                                    // ones left behind by removed values)
+} HashIndex;
+
+// Constructor: dynamically allocates a new, empty HashIndex. If allocation
+// fails, NULL is returned.
+HashIndex* hash_index_new();
+
+// Destructor: frees the index. The values it points at are not freed.
+void hash_index_free(HashIndex* index);
+
+// Takes in a hash and a (non-NULL) value and adds the value to the index. The
+// index grows as needed. Returns 0 on success and non-zero on failure.
+int hash_index_add(HashIndex* index, uint64_t hash, void* value);
+
+// Removes the given value (stored under the given hash) from the index.
+// Returns 0 if it was removed, and non-zero if it couldn't be found.
+int hash_index_remove(HashIndex* index, uint64_t hash, void* value);
+
+// Iterates over the values stored under the given hash. 'position' must point
+// at a zero before the first call. Each call returns the next value (and
+// advances 'position'), until NULL is returned when there are no more.
+void* hash_index_next(HashIndex* index, uint64_t hash, size_t* position);
+
+
+// ============================ Hash Functions ============================= //
+// Returns the hash of a null-terminated string.
+uint64_t hash_index_string(char* string);
+
+// Returns the hash of a 64-bit integer.
+uint64_t hash_index_integer(uint64_t value);
+
+#endif
@@ -0,0 +1,420 @@
+// This module implements journal.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "journal.h"
+#include "scribe.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+// Every journal begins with a header line that identifies the saved list file
+// it applies to (by inode, modification time, and size). Saving the list in
+// full replaces its file, so a journal that no longer matches is stale.
+//
+//      ttydo-journal,<version>,<inode>,<mtime sec>,<mtime nsec>,<size>
+//
+// Each record that follows has the form below, where <arg> is a number whose
+// meaning depends on the operation, and <data> is exactly <length> bytes:
+//
+//      <op>,<task id>,<arg>,<length>:<data>
+//
+// An 'add' record's data holds the whole task:
+//
+//      <is_complete>,<color name>,<title length>,<title><description>
+#define JOURNAL_HEADER_PREFIX "ttydo-journal"
+#define JOURNAL_NO_COLOR "-"    // written when a task's color has no name
+char* make_journal_file_path(char* name);
+int journal_append(TaskList* list, JournalOp op, Task* task);
+char* journal_make_record(TaskList* list, JournalOp op, Task* task, int* length);
+int journal_apply_record(TaskList* list, char op, uint64_t id, long arg,
+                         char* data, size_t data_length);
+Task* journal_task_from_data(uint64_t id, char* data, size_t data_length,
+                            Arena* arena);
+
+
+// =========================== Journal Functions =========================== //
+int journal_record(TaskList* list, JournalOp op, Task* task)
+{
+    if (!list || !task) { return 1; }
+
+    // if saves are deferred, the entire list will be written later anyway
+    if (task_list_saves_deferred()) { return save_task_list(list); }
+
+    // records are keyed by task ID, so if another task shares this one's ID,
+    // replaying the record could change the wrong task. In that case (and if
+    // the record can't be written), we'll fall back to saving the whole list
+    Task* match = task_list_get_by_id(list, task->id);
+    int ambiguous = op == JOURNAL_OP_REMOVE ? match != NULL : match != task;
+    if (ambiguous || journal_append(list, op, task))
+    { return save_task_list(list); }
+
+    // if the journal has grown too large, compact it into the list's file
+    if (journal_file_size(list->name) >= JOURNAL_COMPACT_THRESHOLD)
+    { return save_task_list(list); }
+    return 0;
+}
+
+int journal_replay(TaskList* list, char* name, struct stat* list_stats)
+{
+    if (!list || !name || !list_stats) { return -1; }
+
+    // open the journal for reading - if there isn't one, there's nothing to do
+    char* file_path = make_journal_file_path(name);
+    if (!file_path) { return -1; }
+    int fd = open(file_path, O_RDWR);
+    if (fd < 0)
+    {
+        free(file_path);
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    // read the entire journal into memory
+    struct stat stats;
+    char* buffer = NULL;
+    size_t length = 0;
+    if (!fstat(fd, &stats) && stats.st_size > 0)
+    {
+        buffer = malloc(stats.st_size + 1);
+        while (buffer && length < (size_t) stats.st_size)
+        {
+            ssize_t count = read(fd, buffer + length, stats.st_size - length);
+            if (count < 0 && errno == EINTR) { continue; }
+            if (count <= 0) { break; }
+            length += count;
+        }
+    }
+    if (!buffer)
+    {
+        close(fd);
+        free(file_path);
+        return -1;
+    }
+    buffer[length] = '\0';
+
+    // check the header. If it doesn't describe the file the list was just
+    // loaded from, the list has been saved in full since the journal was
+    // written (or edited by hand), so the journal is discarded
+    char prefix[32] = {'\0'};
+    int version = 0;
+    unsigned long long inode = 0;
+    long sec = 0;
+    long nsec = 0;
+    long size = 0;
+    int consumed = 0;
+    if (sscanf(buffer, "%31[^,],%d,%llu,%ld,%ld,%ld\n%n", prefix, &version,
+               &inode, &sec, &nsec, &size, &consumed) != 6 || !consumed ||
+        strcmp(prefix, JOURNAL_HEADER_PREFIX) || version != JOURNAL_VERSION ||
+        inode != (unsigned long long) list_stats->st_ino ||
+        sec != list_stats->st_mtim.tv_sec ||
+        nsec != list_stats->st_mtim.tv_nsec || size != list_stats->st_size)
+    {
+        unlink(file_path);
+        close(fd);
+        free(buffer);
+        free(file_path);
+        return 0;
+    }
+
+    // apply each record, one at a time
+    int applied = 0;
+    size_t offset = consumed;
+    while (offset < length)
+    {
+        char op = 0;
+        unsigned long long id = 0;
+        long arg = 0;
+        size_t data_length = 0;
+        consumed = 0;
+        if (sscanf(buffer + offset, "%c,%llu,%ld,%zu:%n", &op, &id, &arg,
+                   &data_length, &consumed) != 4 || !consumed ||
+            offset + consumed + data_length >= length ||
+            buffer[offset + consumed + data_length] != '\n')
+        { break; }
+
+        // apply the record and move to the next one
+        char* data = buffer + offset + consumed;
+        data[data_length] = '\0';
+        journal_apply_record(list, op, id, arg, data, data_length);
+        offset += consumed + data_length + 1;
+        applied++;
+    }
+
+    // if we stopped early, the last record was only partially written (ttydo
+    // was probably interrupted while writing it). Cut it off, so any records
+    // appended later can be read back
+    if (offset < length && ftruncate(fd, offset))
+    { applied = -1; }
+
+    close(fd);
+    free(buffer);
+    free(file_path);
+    return applied;
+}
+
+int journal_delete(char* name)
+{
+    char* file_path = make_journal_file_path(name);
+    if (!file_path) { return 1; }
+
+    // attempt to delete the file. A journal that doesn't exist is fine
+    int result = unlink(file_path) && errno != ENOENT;
+    free(file_path);
+    return result;
+}
+
+int64_t journal_file_size(char* name)
+{
+    char* file_path = make_journal_file_path(name);
+    if (!file_path) { return 0; }
+
+    struct stat stats;
+    int stat_result = stat(file_path, &stats);
+    free(file_path);
+    if (stat_result) { return 0; }
+    return stats.st_size;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Takes in the name of a task list and builds the path to its journal. The
+// returned string is dynamically allocated. Returns NULL on failure.
+char* make_journal_file_path(char* name)
+{
+    char* list_path = make_task_list_file_path(name);
+    if (!list_path) { return NULL; }
+
+    int length = strlen(list_path) + strlen(JOURNAL_SUFFIX) + 1;
+    char* result = calloc(length, sizeof(char));
+    if (result)
+    { snprintf(result, length, "%s%s", list_path, JOURNAL_SUFFIX); }
+    free(list_path);
+    return result;
+}
+
+// Appends a single record to the list's journal, creating the journal (and
+// writing its header) if it doesn't exist yet. The record is flushed to disk
+// before returning. Returns 0 on success and a non-zero value on failure.
+int journal_append(TaskList* list, JournalOp op, Task* task)
+{
+    // build the record
+    int record_length = 0;
+    char* record = journal_make_record(list, op, task, &record_length);
+    if (!record) { return 1; }
+
+    // open the journal for appending
+    char* file_path = make_journal_file_path(list->name);
+    if (!file_path)
+    {
+        free(record);
+        return 1;
+    }
+    int fd = open(file_path, O_WRONLY | O_APPEND | O_CREAT, 0666);
+    free(file_path);
+    struct stat stats;
+    if (fd < 0 || fstat(fd, &stats))
+    {
+        if (fd >= 0) { close(fd); }
+        free(record);
+        return 1;
+    }
+
+    // if the journal is new, it needs a header that identifies the list file
+    // it's being applied to. (If the list has never been saved, there's
+    // nothing to apply it to, so we'll give up)
+    char header[128] = {'\0'};
+    int header_length = 0;
+    if (stats.st_size == 0)
+    {
+        char* list_path = make_task_list_file_path(list->name);
+        struct stat list_stats;
+        int stat_result = list_path ? stat(list_path, &list_stats) : 1;
+        if (list_path) { free(list_path); }
+        if (stat_result)
+        {
+            close(fd);
+            free(record);
+            return 1;
+        }
+        header_length = snprintf(header, 128, "%s,%d,%llu,%ld,%ld,%ld\n",
+                                 JOURNAL_HEADER_PREFIX, JOURNAL_VERSION,
+                                 (unsigned long long) list_stats.st_ino,
+                                 (long) list_stats.st_mtim.tv_sec,
+                                 (long) list_stats.st_mtim.tv_nsec,
+                                 (long) list_stats.st_size);
+    }
+
+    // write the header (if needed) and the record with a single call, so
+    // they're appended together
+    int total_length = header_length + record_length;
+    char buffer[total_length];
+    memcpy(buffer, header, header_length);
+    memcpy(buffer + header_length, record, record_length);
+    free(record);
+    int result = 0;
+    int written = 0;
+    while (written < total_length && !result)
+    {
+        ssize_t count = write(fd, buffer + written, total_length - written);
+        if (count < 0 && errno != EINTR)
+        { result = 1; }
+        else if (count > 0)
+        { written += count; }
+    }
+
+    // flush the record to disk
+    if (!result && fdatasync(fd)) { result = 1; }
+    close(fd);
+    return result;
+}
+
+// Builds a single journal record for the given operation, using the task's
+// current state. The record's length is saved to 'length'. The returned string
+// is dynamically allocated. Returns NULL on failure.
+char* journal_make_record(TaskList* list, JournalOp op, Task* task, int* length)
+{
+    // pick out the number and the data that make up the record
+    long arg = 0;
+    char* data = "";
+    char* add_data = NULL;
+    const char* color_name = NULL;
+    switch (op)
+    {
+        case JOURNAL_OP_ADD:
+        {
+            // the record holds the entire task (and where it was inserted)
+            arg = task_list_index_of(list, task);
+            color_name = color_name_from_index(task->color);
+            if (!color_name) { color_name = JOURNAL_NO_COLOR; }
+            char* title = task->title ? task->title : "";
+            char* desc = task->description ? task->description : "";
+            int add_length = strlen(title) + strlen(desc) +
+                             strlen(color_name) + 32;
+            add_data = calloc(add_length, sizeof(char));
+            if (!add_data) { return NULL; }
+            snprintf(add_data, add_length, "%d,%s,%d,%s%s",
+                     task->is_complete != 0, color_name, (int) strlen(title),
+                     title, desc);
+            data = add_data;
+            break;
+        }
+        case JOURNAL_OP_REMOVE:
+            break;
+        case JOURNAL_OP_COMPLETE:
+            arg = task->is_complete != 0;
+            break;
+        case JOURNAL_OP_TITLE:
+            if (task->title) { data = task->title; }
+            break;
+        case JOURNAL_OP_DESCRIPTION:
+            if (task->description) { data = task->description; }
+            break;
+        case JOURNAL_OP_COLOR:
+            color_name = color_name_from_index(task->color);
+            data = color_name ? (char*) color_name : JOURNAL_NO_COLOR;
+            break;
+        case JOURNAL_OP_MOVE:
+            arg = task_list_index_of(list, task);
+            break;
+        default:
+            return NULL;
+    }
+
+    // put the record together
+    int data_length = strlen(data);
+    int record_max_length = data_length + 96;
+    char* record = calloc(record_max_length, sizeof(char));
+    if (record)
+    {
+        *length = snprintf(record, record_max_length, "%c,%llu,%ld,%d:%s\n",
+                           (char) op, (unsigned long long) task->id, arg,
+                           data_length, data);
+    }
+    if (add_data) { free(add_data); }
+    return record;
+}
+
+// Applies a single journal record to the given list. Records that refer to
+// tasks that don't exist (or, for 'add' records, tasks that already exist)
+// are ignored. Returns 0 if the record was applied and 1 if it was ignored.
+int journal_apply_record(TaskList* list, char op, uint64_t id, long arg,
+                         char* data, size_t data_length)
+{
+    Task* task = task_list_get_by_id(list, id);
+    if (op == JOURNAL_OP_ADD)
+    {
+        if (task) { return 1; }
+        task = journal_task_from_data(id, data, data_length, list->arena);
+        if (!task) { return 1; }
+
+        // insert it at the recorded position (or the end of the list)
+        if (arg >= 0 && arg < list->size)
+        { task_list_insert(list, task, arg); }
+        else
+        { task_list_append(list, task); }
+        return 0;
+    }
+    if (!task) { return 1; }
+
+    switch (op)
+    {
+        case JOURNAL_OP_REMOVE:
+            task_free(task_list_remove(list, task));
+            break;
+        case JOURNAL_OP_COMPLETE:
+            task_list_set_task_complete(list, task, arg);
+            break;
+        case JOURNAL_OP_TITLE:
+            task_list_set_task_title(list, task, data);
+            break;
+        case JOURNAL_OP_DESCRIPTION:
+            task_set_description(task, data);
+            break;
+        case JOURNAL_OP_COLOR:
+            if (strcmp(data, JOURNAL_NO_COLOR)) { task_set_color(task, data); }
+            break;
+        case JOURNAL_OP_MOVE:
+            // remove the task, then re-insert it at the recorded position
+            if (arg < 0 || arg >= list->size) { return 1; }
+            task_list_remove(list, task);
+            if (arg < list->size) { task_list_insert(list, task, arg); }
+            else { task_list_append(list, task); }
+            break;
+        default:
+            return 1;
+    }
+    return 0;
+}
+
+// Takes in the data held by an 'add' record and creates a new task from it
+// (allocated from the given arena, or the heap if it's NULL). Returns NULL on
+// failure.
+Task* journal_task_from_data(uint64_t id, char* data, size_t data_length,
+                            Arena* arena)
+{
+    int is_complete = 0;
+    int title_length = 0;
+    int consumed = 0;
+    char color[COLOR_NAME_MAX_LENGTH] = {'\0'};
+    if (sscanf(data, "%d,%63[^,],%d,%n", &is_complete, color, &title_length,
+               &consumed) != 3 || !consumed || title_length < 0 ||
+        consumed + (size_t) title_length > data_length)
+    { return NULL; }
+
+    // split the title from the description
+    char title[title_length + 1];
+    memcpy(title, data + consumed, title_length);
+    title[title_length] = '\0';
+    Task* task = task_new_with_id(title, data + consumed + title_length, id,
+                                  arena);
+    if (!task) { return NULL; }
+
+    task->is_complete = is_complete != 0;
+    if (strcmp(color, JOURNAL_NO_COLOR)) { task_set_color(task, color); }
+    return task;
+}
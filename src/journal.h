@@ -0,0 +1,64 @@
+// This header file defines the journal: an append-only log of the changes made
+// to a task list since it was last saved in full. Changing a single task only
+// appends one small record to the list's journal, instead of re-writing every
+// task in the list. When a list is loaded, its journal is replayed on top of
+// the saved list, and once the journal grows too large the list is saved in
+// full (which deletes the journal).
+//
+//      Connor Shugg
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+// Module inclusions
+#include <inttypes.h>
+#include <sys/stat.h>
+#include "tasklist.h"
+
+// ========================= Constants and Macros ========================== //
+#define JOURNAL_SUFFIX ".journal"       // appended to a list's file path
+#define JOURNAL_VERSION 1               // version written to the header line
+#define JOURNAL_COMPACT_THRESHOLD 65536 // journal size (bytes) that triggers a
+                                        // full save of the list
+
+// The types of operations that can be recorded in a journal. Each record is
+// keyed by the ID of the task it applies to, and holds the task's new state
+// (rather than the change itself), so replaying a record more than once has
+// no further effect.
+typedef enum _JournalOp
+{
+    JOURNAL_OP_ADD = 'a',           // a task was inserted
+    JOURNAL_OP_REMOVE = 'r',        // a task was removed
+    JOURNAL_OP_COMPLETE = 'c',      // a task's 'is_complete' flag was set
+    JOURNAL_OP_TITLE = 't',         // a task's title was set
+    JOURNAL_OP_DESCRIPTION = 'd',   // a task's description was set
+    JOURNAL_OP_COLOR = 'k',         // a task's color was set
+    JOURNAL_OP_MOVE = 'm'           // a task was moved to a new position
+} JournalOp;
+
+
+// =========================== Journal Functions =========================== //
+// Takes in a task list, an operation, and the task it was applied to (the list
+// should already reflect the change), and records it in the list's journal.
+// If the journal can't be written, or it has grown past the compaction
+// threshold, the entire list is saved instead. Returns 0 on success and a
+// non-zero value on failure.
+int journal_record(TaskList* list, JournalOp op, Task* task);
+
+// Takes in a freshly-loaded task list, the name it was loaded with, and the
+// stats of the file it was loaded from, and replays the list's journal (if it
+// has one) on top of it. A journal left over from before the list was last
+// saved in full is deleted instead. Returns the number of records applied, or
+// -1 on failure.
+int journal_replay(TaskList* list, char* name, struct stat* list_stats);
+
+// Takes in the name of a task list and deletes its journal, if it has one.
+// Returns 0 on success (or if there was no journal) and a non-zero value on
+// failure.
+int journal_delete(char* name);
+
+// Takes in the name of a task list and returns the size of its journal, in
+// bytes. If the list has no journal, 0 is returned.
+int64_t journal_file_size(char* name);
+
+#endif
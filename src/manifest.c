@@ -0,0 +1,624 @@
+// This module implements manifest.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "manifest.h"
+#include "scribe.h"
+#include "journal.h"
+#include "taskbin.h"
+#include "visual/output.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+#define MANIFEST_HEADER_PREFIX "ttydo-manifest"
+#define MANIFEST_LIST_HEADER_MAX_LENGTH 512 // longest list file header line
+#define MANIFEST_LEGACY_PATH_FORMAT "%s/manifest" // where older versions put it
+char* make_manifest_file_path();
+int manifest_read(ManifestEntry** entries, int* count, int64_t* dir_sec,
+                  int64_t* dir_nsec);
+int manifest_reconcile_directory(ManifestEntry** entries, int* count);
+int manifest_entry_refresh(ManifestEntry* entry);
+int manifest_entry_from_list_header(ManifestEntry* entry);
+int manifest_entry_is_current(ManifestEntry* entry, struct stat* stats,
+                              int64_t journal_size);
+char* manifest_entry_to_string(ManifestEntry* entry);
+int manifest_entry_from_string(char* string, ManifestEntry* entry);
+int manifest_entry_cmp(const void* a, const void* b);
+
+
+// ========================= Manifest Entry Struct ========================= //
+void manifest_entry_free_fields(ManifestEntry* entry)
+{
+    if (!entry) { return; }
+
+    // free the string fields and null them out
+    if (entry->name) { free(entry->name); }
+    if (entry->file_name) { free(entry->file_name); }
+    entry->name = NULL;
+    entry->file_name = NULL;
+}
+
+int manifest_entry_update(ManifestEntry* entry, TaskList* list, int check_file)
+{
+    // check for NULL pointers
+    if (!entry || !list || !list->name) { return -1; }
+    int changed = 0;
+
+    // copy the list's name, if it's different
+    if (!entry->name || strcmp(entry->name, list->name))
+    {
+        char* name = strdup(list->name);
+        if (!name) { return -1; }
+        if (entry->name) { free(entry->name); }
+        entry->name = name;
+        changed = 1;
+    }
+
+    // the list keeps its own count of completed tasks
+    int completed = list->completed_count;
+    changed = changed || entry->size != list->size ||
+              entry->completed != completed;
+    entry->size = list->size;
+    entry->completed = completed;
+
+    // convert the list's color to a name
+    const char* color_name = color_name_from_index(list->color);
+    if (!color_name) { color_name = ""; }
+    if (strcmp(entry->color, color_name))
+    {
+        snprintf(entry->color, COLOR_NAME_MAX_LENGTH, "%s", color_name);
+        changed = 1;
+    }
+    changed = changed || entry->format != list->format;
+    entry->format = list->format;
+
+    // if requested, stat the list's file to pick up its current state
+    if (check_file && entry->file_name)
+    {
+        char* file_path = make_task_list_file_path(entry->file_name);
+        if (!file_path) { return -1; }
+        struct stat stats;
+        int stat_result = stat(file_path, &stats);
+        free(file_path);
+        if (stat_result) { return -1; }
+
+        int64_t journal_size = journal_file_size(entry->file_name);
+        if (!manifest_entry_is_current(entry, &stats, journal_size))
+        {
+            entry->mtime_sec = stats.st_mtim.tv_sec;
+            entry->mtime_nsec = stats.st_mtim.tv_nsec;
+            entry->file_size = stats.st_size;
+            entry->journal_size = journal_size;
+            changed = 1;
+        }
+    }
+
+    return changed;
+}
+
+int manifest_entry_is_stale(ManifestEntry* entry)
+{
+    if (!entry || !entry->file_name) { return 1; }
+
+    char* file_path = make_task_list_file_path(entry->file_name);
+    if (!file_path) { return 1; }
+    struct stat stats;
+    int stat_result = stat(file_path, &stats);
+    free(file_path);
+    if (stat_result) { return 1; }
+
+    return !manifest_entry_is_current(entry, &stats,
+                                      journal_file_size(entry->file_name));
+}
+
+
+// =========================== Manifest Functions ========================== //
+int manifest_load(ManifestEntry** entries)
+{
+    if (!entries) { return -1; }
+
+    // stat the home directory. Its modification time tells us whether any
+    // list files were created, deleted, or renamed since the manifest was
+    // last written
+    char* home = get_home_directory();
+    if (!home) { return -1; }
+    struct stat home_stats;
+    if (stat(home, &home_stats)) { return -1; }
+
+    // read the existing manifest. If it's missing or can't be parsed, we'll
+    // start from scratch (which rebuilds every entry)
+    ManifestEntry* result = NULL;
+    int count = 0;
+    int64_t dir_sec = -1;
+    int64_t dir_nsec = -1;
+    int dirty = 0;
+    if (manifest_read(&result, &count, &dir_sec, &dir_nsec))
+    {
+        result = NULL;
+        count = 0;
+        dirty = 1;
+    }
+
+    // if the directory has changed, re-scan it to pick up new files and drop
+    // entries for files that no longer exist
+    if (dirty || dir_sec != home_stats.st_mtim.tv_sec ||
+        dir_nsec != home_stats.st_mtim.tv_nsec)
+    {
+        if (manifest_reconcile_directory(&result, &count))
+        {
+            for (int i = 0; i < count; i++)
+            { manifest_entry_free_fields(&result[i]); }
+            free(result);
+            return -1;
+        }
+        dirty = 1;
+    }
+
+    // check each entry's file - if it was modified since the entry was taken
+    // (for example, by an editor), rebuild just that entry
+    int i = 0;
+    while (i < count)
+    {
+        int refresh_result = manifest_entry_refresh(&result[i]);
+        // if the file disappeared, drop the entry by shifting the others down
+        if (refresh_result < 0)
+        {
+            manifest_entry_free_fields(&result[i]);
+            memmove(result + i, result + i + 1,
+                    (count - i - 1) * sizeof(ManifestEntry));
+            count--;
+            dirty = 1;
+            continue;
+        }
+        dirty = dirty || refresh_result;
+        i++;
+    }
+
+    // keep the entries sorted by file name
+    qsort(result, count, sizeof(ManifestEntry), manifest_entry_cmp);
+
+    // if anything changed, write the manifest back out. (A failed write isn't
+    // fatal: the manifest is only a cache, and it'll be rebuilt next time)
+    if (dirty && count > 0)
+    {
+        ManifestEntry** pointers = calloc(count, sizeof(ManifestEntry*));
+        if (pointers)
+        {
+            for (int i = 0; i < count; i++) { pointers[i] = &result[i]; }
+            manifest_save(pointers, count);
+            free(pointers);
+        }
+    }
+    else if (dirty)
+    { manifest_save(NULL, 0); }
+
+    *entries = result;
+    return count;
+}
+
+int manifest_save(ManifestEntry** entries, int count)
+{
+    if (!entries && count > 0) { return 1; }
+
+    // build the manifest's path (creating its directory, if needed), and
+    // remove the one older versions kept next to the lists
+    char* file_path = make_manifest_file_path();
+    if (!file_path) { return 1; }
+    char* home = get_home_directory();
+    int legacy_length = strlen(home) + strlen(MANIFEST_LEGACY_PATH_FORMAT);
+    char legacy_path[legacy_length];
+    snprintf(legacy_path, legacy_length, MANIFEST_LEGACY_PATH_FORMAT, home);
+    unlink(legacy_path);
+
+    // stat the home directory AFTER making any changes to it, so the recorded
+    // time reflects our own changes. (Writing the manifest itself only
+    // changes its own directory)
+    struct stat home_stats;
+    if (stat(home, &home_stats))
+    {
+        free(file_path);
+        return 1;
+    }
+
+    // build the header line (which records how many entries follow, so a
+    // manifest that's missing some is never trusted), then one line per entry
+    OutputBuffer* out = output_buffer_new();
+    if (!out)
+    {
+        free(file_path);
+        return 1;
+    }
+    output_printf(out, "%s,%d,%ld,%ld,%d\n", MANIFEST_HEADER_PREFIX,
+                  MANIFEST_VERSION, (long) home_stats.st_mtim.tv_sec,
+                  (long) home_stats.st_mtim.tv_nsec, count);
+    int failed = 0;
+    for (int i = 0; i < count && !failed; i++)
+    {
+        char* line = manifest_entry_to_string(entries[i]);
+        if (!line) { failed = 1; break; }
+        output_printf(out, "%s\n", line);
+        free(line);
+    }
+
+    // write it all out at once, replacing the old manifest
+    failed = failed || out->failed ||
+             write_file_atomically(file_path, out->data, out->length);
+    output_buffer_free(out);
+    free(file_path);
+    return failed;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Builds the path to the manifest file, creating the directory it's kept in
+// if it doesn't exist yet. The returned string is dynamically allocated.
+// Returns NULL on failure.
+char* make_manifest_file_path()
+{
+    char* home = get_home_directory();
+    if (!home) { return NULL; }
+
+    int length = strlen(home) + strlen(MANIFEST_DIRECTORY_NAME) +
+                 strlen(MANIFEST_FILE_NAME) + 3;
+    char* result = calloc(length, sizeof(char));
+    if (!result) { return NULL; }
+    snprintf(result, length, "%s/%s", home, MANIFEST_DIRECTORY_NAME);
+    struct stat stats;
+    if (stat(result, &stats) && mkdir(result, 0777))
+    {
+        free(result);
+        return NULL;
+    }
+    snprintf(result, length, "%s/%s/%s", home, MANIFEST_DIRECTORY_NAME,
+             MANIFEST_FILE_NAME);
+    return result;
+}
+
+// Attempts to read the manifest file into a dynamically-allocated array of
+// entries. The directory modification time recorded in the header is saved to
+// 'dir_sec' and 'dir_nsec'. Returns 0 on success and a non-zero value if the
+// manifest doesn't exist, couldn't be parsed, or doesn't hold as many entries
+// as its header says it does.
+int manifest_read(ManifestEntry** entries, int* count, int64_t* dir_sec,
+                  int64_t* dir_nsec)
+{
+    char* file_path = make_manifest_file_path();
+    if (!file_path) { return 1; }
+    FILE* file = fopen(file_path, "r");
+    free(file_path);
+    if (!file) { return 1; }
+
+    // read and check the header line
+    char* buffer = NULL;
+    size_t buffer_length = 0;
+    long sec = 0;
+    long nsec = 0;
+    int version = 0;
+    int expected = 0;
+    char prefix[32] = {'\0'};
+    if (getline(&buffer, &buffer_length, file) <= 0 ||
+        sscanf(buffer, "%31[^,],%d,%ld,%ld,%d", prefix, &version, &sec, &nsec,
+               &expected) != 5 ||
+        strcmp(prefix, MANIFEST_HEADER_PREFIX) || version != MANIFEST_VERSION)
+    {
+        free(buffer);
+        fclose(file);
+        return 1;
+    }
+
+    // read each entry line, growing the array as needed
+    int capacity = 8;
+    int length = 0;
+    ManifestEntry* result = calloc(capacity, sizeof(ManifestEntry));
+    int failed = !result;
+    while (!failed && getline(&buffer, &buffer_length, file) > 0)
+    {
+        if (length == capacity)
+        {
+            capacity <<= 1; // multiply by 2
+            ManifestEntry* expanded = realloc(result, capacity * sizeof(ManifestEntry));
+            if (!expanded) { failed = 1; break; }
+            result = expanded;
+        }
+
+        // strip the newline and parse the entry
+        char* newline = strchr(buffer, '\n');
+        if (newline) { *newline = '\0'; }
+        memset(&result[length], 0, sizeof(ManifestEntry));
+        if (manifest_entry_from_string(buffer, &result[length]))
+        { failed = 1; break; }
+        length++;
+    }
+    free(buffer);
+    fclose(file);
+
+    // if there aren't as many entries as the header says, some are missing,
+    // so the whole directory has to be scanned again. On failure, free
+    // everything we parsed
+    failed = failed || length != expected;
+    if (failed)
+    {
+        for (int i = 0; i < length; i++)
+        { manifest_entry_free_fields(&result[i]); }
+        free(result);
+        return 1;
+    }
+
+    *entries = result;
+    *count = length;
+    *dir_sec = sec;
+    *dir_nsec = nsec;
+    return 0;
+}
+
+// Re-scans the ttydo directory and rebuilds the given array of entries so it
+// matches the task list files on disk. Entries for existing files are kept as
+// they are, entries for deleted files are dropped, and new (empty) entries are
+// created for new files. Returns 0 on success and a non-zero value on failure.
+int manifest_reconcile_directory(ManifestEntry** entries, int* count)
+{
+    char** names = NULL;
+    int name_count = count_saved_task_lists(&names);
+    if (name_count < 0 || !names) { return 1; }
+
+    // sort the old entries so we can binary-search them by file name
+    ManifestEntry* old = *entries;
+    int old_count = *count;
+    if (old_count > 0)
+    { qsort(old, old_count, sizeof(ManifestEntry), manifest_entry_cmp); }
+
+    // build the new array of entries
+    ManifestEntry* result = calloc(name_count > 0 ? name_count : 1,
+                                   sizeof(ManifestEntry));
+    if (!result)
+    {
+        for (int i = 0; i < name_count; i++) { free(names[i]); }
+        free(names);
+        return 1;
+    }
+    for (int i = 0; i < name_count; i++)
+    {
+        // look for an existing entry. If one is found, move it over
+        ManifestEntry key = {0};
+        key.file_name = names[i];
+        ManifestEntry* match = NULL;
+        if (old_count > 0)
+        {
+            match = bsearch(&key, old, old_count, sizeof(ManifestEntry),
+                            manifest_entry_cmp);
+        }
+        if (match && match->name)
+        {
+            result[i] = *match;
+            match->name = NULL; // mark the old entry as moved
+            free(names[i]);
+            continue;
+        }
+
+        // otherwise, create a new entry that will be filled in when its file
+        // is checked (its modification time will never match)
+        result[i].file_name = names[i];
+        result[i].mtime_sec = -1;
+        result[i].mtime_nsec = -1;
+        result[i].file_size = -1;
+        result[i].journal_size = -1;
+    }
+    free(names);
+
+    // free any old entries that weren't moved over (their files are gone)
+    for (int i = 0; i < old_count; i++)
+    {
+        if (old[i].name) { manifest_entry_free_fields(&old[i]); }
+        else if (old[i].file_name)
+        {
+            // moved entries share their file name with the new array
+            old[i].file_name = NULL;
+        }
+    }
+    free(old);
+
+    *entries = result;
+    *count = name_count;
+    return 0;
+}
+
+// Checks an entry against its file (and journal) on disk. If either was
+// modified since the entry was taken, the entry is rebuilt - from just the
+// file's header line, if it can be, or by loading the list. Returns 1 if the
+// entry was rebuilt, 0 if it was already current, and -1 if the file no
+// longer exists.
+int manifest_entry_refresh(ManifestEntry* entry)
+{
+    char* file_path = make_task_list_file_path(entry->file_name);
+    if (!file_path) { return -1; }
+    struct stat stats;
+    int stat_result = stat(file_path, &stats);
+    free(file_path);
+    if (stat_result) { return -1; }
+
+    // if the file hasn't changed, there's nothing to do
+    int64_t journal_size = journal_file_size(entry->file_name);
+    if (entry->name && manifest_entry_is_current(entry, &stats, journal_size))
+    { return 0; }
+
+    // if the list has no journal (which holds changes the header doesn't
+    // reflect), its file's header line may be all we need
+    int rebuilt = journal_size == 0 && !manifest_entry_from_list_header(entry);
+
+    // otherwise, load the list and rebuild the entry from it. If the list
+    // can't be parsed, we'll keep an empty entry named after the file, so it
+    // still shows up (and can be deleted)
+    TaskList* list = rebuilt ? NULL : load_task_list(entry->file_name);
+    if (list)
+    {
+        manifest_entry_update(entry, list, 0);
+        task_list_free(list);
+
+        // loading the list may have discarded a stale journal
+        journal_size = journal_file_size(entry->file_name);
+    }
+    else if (!rebuilt)
+    {
+        if (!entry->name) { entry->name = strdup(entry->file_name); }
+        entry->size = 0;
+        entry->completed = 0;
+        entry->color[0] = '\0';
+        entry->format = TASK_LIST_FORMAT_TEXT;
+    }
+    entry->mtime_sec = stats.st_mtim.tv_sec;
+    entry->mtime_nsec = stats.st_mtim.tv_nsec;
+    entry->file_size = stats.st_size;
+    entry->journal_size = journal_size;
+    return 1;
+}
+
+// Rebuilds an entry's name, counts, and color from the header line of its
+// list's file, without reading any of its tasks. This only works for text
+// files whose header records a completed count. Returns 0 on success, and a
+// non-zero value if the list needs to be loaded instead.
+int manifest_entry_from_list_header(ManifestEntry* entry)
+{
+    char* file_path = make_task_list_file_path(entry->file_name);
+    if (!file_path) { return 1; }
+    FILE* file = fopen(file_path, "r");
+    free(file_path);
+    if (!file) { return 1; }
+
+    // read just enough of the file to hold the header line
+    char buffer[MANIFEST_LIST_HEADER_MAX_LENGTH + 1];
+    size_t length = fread(buffer, 1, MANIFEST_LIST_HEADER_MAX_LENGTH, file);
+    fclose(file);
+    char* newline = memchr(buffer, '\n', length);
+    if (!newline || taskbin_is_binary(buffer, length)) { return 1; }
+    newline[1] = '\0';
+
+    // parse it as a current (or version 1) header
+    int size = -1;
+    int completed = -1;
+    int consumed = 0;
+    TaskList* list = NULL;
+    if (buffer[0] == '#')
+    {
+        list = task_list_new_from_scribe_header(buffer, length, &consumed,
+                                                &size, &completed);
+    }
+    else
+    { list = task_list_new_from_scribe_string(buffer, &size, &completed); }
+    if (!list || size < 0 || completed < 0 || completed > size)
+    {
+        task_list_free(list);
+        return 1;
+    }
+
+    // copy the summary over
+    char* name = strdup(list->name);
+    if (!name)
+    {
+        task_list_free(list);
+        return 1;
+    }
+    if (entry->name) { free(entry->name); }
+    entry->name = name;
+    entry->size = size;
+    entry->completed = completed;
+    snprintf(entry->color, COLOR_NAME_MAX_LENGTH, "%s",
+             color_name_from_index(list->color));
+    entry->format = TASK_LIST_FORMAT_TEXT;
+    task_list_free(list);
+    return 0;
+}
+
+// Returns 1 if the given file stats and journal size match the entry's cached
+// file state, and 0 if they don't.
+int manifest_entry_is_current(ManifestEntry* entry, struct stat* stats,
+                              int64_t journal_size)
+{
+    return entry->mtime_sec == stats->st_mtim.tv_sec &&
+           entry->mtime_nsec == stats->st_mtim.tv_nsec &&
+           entry->file_size == stats->st_size &&
+           entry->journal_size == journal_size;
+}
+
+// Converts a manifest entry into a single line of text (without the newline).
+// The file name is length-prefixed and the list name comes last, so both may
+// contain commas. The returned string is dynamically allocated.
+char* manifest_entry_to_string(ManifestEntry* entry)
+{
+    if (!entry || !entry->name || !entry->file_name) { return NULL; }
+
+    int length = strlen(entry->name) + strlen(entry->file_name) +
+                 COLOR_NAME_MAX_LENGTH + 128;
+    char* result = calloc(length, sizeof(char));
+    if (!result) { return NULL; }
+    snprintf(result, length, "%d,%d,%ld,%ld,%ld,%ld,%d,%s,%d,%s%s",
+             entry->size, entry->completed, (long) entry->mtime_sec,
+             (long) entry->mtime_nsec, (long) entry->file_size,
+             (long) entry->journal_size, entry->format, entry->color,
+             (int) strlen(entry->file_name), entry->file_name, entry->name);
+    return result;
+}
+
+// Parses a line produced by 'manifest_entry_to_string' into the given entry.
+// Returns 0 on success and a non-zero value on failure.
+int manifest_entry_from_string(char* string, ManifestEntry* entry)
+{
+    // parse the fixed-width numeric fields and the color name
+    long size = 0;
+    long completed = 0;
+    long sec = 0;
+    long nsec = 0;
+    long file_size = 0;
+    long journal_size = 0;
+    int format = 0;
+    int file_name_length = 0;
+    int consumed = 0;
+    char color[COLOR_NAME_MAX_LENGTH] = {'\0'};
+    if (sscanf(string, "%ld,%ld,%ld,%ld,%ld,%ld,%d,%63[^,],%d,%n", &size,
+               &completed, &sec, &nsec, &file_size, &journal_size, &format,
+               color, &file_name_length, &consumed) != 9)
+    {
+        // an empty color name leaves '%[' with nothing to match, so try again
+        // without it
+        color[0] = '\0';
+        if (sscanf(string, "%ld,%ld,%ld,%ld,%ld,%ld,%d,,%d,%n", &size,
+                   &completed, &sec, &nsec, &file_size, &journal_size, &format,
+                   &file_name_length, &consumed) != 8)
+        { return 1; }
+    }
+
+    // the rest of the line holds the file name, then the list name
+    char* rest = string + consumed;
+    if (file_name_length <= 0 || consumed == 0 ||
+        (int) strlen(rest) < file_name_length)
+    { return 1; }
+    entry->file_name = strndup(rest, file_name_length);
+    entry->name = strdup(rest + file_name_length);
+    if (!entry->file_name || !entry->name)
+    {
+        manifest_entry_free_fields(entry);
+        return 1;
+    }
+
+    entry->size = size;
+    entry->completed = completed;
+    entry->mtime_sec = sec;
+    entry->mtime_nsec = nsec;
+    entry->file_size = file_size;
+    entry->journal_size = journal_size;
+    entry->format = format;
+    snprintf(entry->color, COLOR_NAME_MAX_LENGTH, "%s", color);
+    return 0;
+}
+
+// Comparison function used to sort (and search) entries by their file name.
+int manifest_entry_cmp(const void* a, const void* b)
+{
+    const ManifestEntry* e1 = a;
+    const ManifestEntry* e2 = b;
+    return strcmp(e1->file_name, e2->file_name);
+}
@@ -0,0 +1,75 @@
+// This header file defines the manifest: a small index file kept in ttydo's
+// home directory that caches a summary of every saved task list. Commands that
+// only need a list's name, size, or completion count can be served from the
+// manifest without ever parsing the list's file.
+//
+//      Connor Shugg
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+// Module inclusions
+#include <inttypes.h>
+#include "tasklist.h"
+#include "visual/colors.h"
+
+// ========================= Constants and Macros ========================== //
+#define MANIFEST_DIRECTORY_NAME "cache" // directory in ~/.ttydo it's kept in
+#define MANIFEST_FILE_NAME "manifest"   // name of the file in that directory
+#define MANIFEST_VERSION 4              // version written to the header line
+
+
+// ========================= Manifest Entry Struct ========================= //
+// The 'ManifestEntry' struct holds the cached summary of a single task list,
+// along with the state of the list's file (and journal) when the summary was
+// taken. If the file's modification time or size, or the journal's size, no
+// longer match, the entry is stale.
+typedef struct _ManifestEntry
+{
+    char* name;                         // the task list's name
+    char* file_name;                    // the list's file name (no suffix)
+    int size;                           // number of tasks in the list
+    int completed;                      // number of completed tasks
+    char color[COLOR_NAME_MAX_LENGTH];  // name of the list's color
+    int format;                         // file format (TASK_LIST_FORMAT_*)
+    int64_t mtime_sec;                  // file modification time (seconds)
+    int64_t mtime_nsec;                 // file modification time (nanoseconds)
+    int64_t file_size;                  // file size, in bytes
+    int64_t journal_size;               // size of the list's journal, in bytes
+} ManifestEntry;
+
+// Takes in a pointer to a ManifestEntry and frees the memory held by its
+// fields. The struct itself is not freed.
+void manifest_entry_free_fields(ManifestEntry* entry);
+
+// Takes in a ManifestEntry and the loaded TaskList it describes, and updates
+// the entry's summary fields from the list. If 'check_file' is non-zero, the
+// list's file and journal are also stat'd to update the cached modification
+// time and sizes.
+// Returns 1 if any field changed, 0 if nothing changed, and -1 on error.
+int manifest_entry_update(ManifestEntry* entry, TaskList* list, int check_file);
+
+// Stats the list file (and journal) described by the given entry, and returns
+// non-zero if either has changed since the entry was last updated (or if the
+// file can't be found). Returns 0 if the entry is still current.
+int manifest_entry_is_stale(ManifestEntry* entry);
+
+
+// =========================== Manifest Functions ========================== //
+// Attempts to read the manifest from disk and reconcile it with the task list
+// files in the ttydo directory. New, deleted, or modified files (such as ones
+// edited outside of ttydo) are detected through modification times, and only
+// those entries are rebuilt. If anything changed, the manifest is rewritten.
+// On success, the number of entries is returned, and a dynamically-allocated
+// array of entries (sorted by file name) is saved to the given pointer.
+// On failure, -1 is returned.
+int manifest_load(ManifestEntry** entries);
+
+// Takes in an array of ManifestEntry pointers and its length, and attempts to
+// write them out to the manifest file. The file is replaced atomically, so
+// it's never seen half-written (and it's kept in its own directory, so doing
+// so doesn't change the modification time of the directory the lists are
+// in). Returns 0 on success and a non-zero value on failure.
+int manifest_save(ManifestEntry** entries, int count);
+
+#endif
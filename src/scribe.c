@@ -9,7 +9,13 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <pthread.h>
 #include "scribe.h"
+#include "journal.h"
+#include "taskbin.h"
 
 // =============== Constants and Helper Function Prototypes ================ //
 const char* TTYDO_FOLDER = ".ttydo";
@@ -17,9 +23,18 @@ const char* TTYDO_LIST_FOLDER = "lists";
 const char* TTYDO_LIST_SUFFIX = ".tasklist";
 #define TTYDO_HOME_DIR_LENGTH 1024
 char ttydo_home_dir[TTYDO_HOME_DIR_LENGTH] = {'\0'}; // holds the home path
+pthread_once_t ttydo_home_dir_once = PTHREAD_ONCE_INIT; // builds it once
+int task_list_saves_are_deferred = 0; // set while saves are deferred
+#define SCRIBE_MIN_LINE_LENGTH 24   // fewer bytes than any task's line takes
 // Function prototypes
-char* get_home_directory();
-char* make_task_list_file_path(char* name);
+void init_home_directory();
+int write_task_list(TaskList* list);
+char* task_list_to_scribe_buffer(TaskList* list, size_t* length);
+TaskList* load_binary_task_list(FILE* file, struct stat* stats);
+TaskList* load_text_task_list(FILE* file, struct stat* stats);
+TaskList* parse_text_task_list(char* buffer, size_t length);
+TaskList* load_text_task_list_v1(FILE* file, struct stat* stats);
+int task_list_new_arena(TaskList* list, size_t file_length);
 char* format_string_for_file_name(char* string, int string_length);
 int file_is_tasklist(char* path);
 
@@ -32,41 +47,25 @@ int save_task_list(TaskList* list)
     // if we were given a NULL pointer, return a non-zero value
     if (!list) { return 1; }
 
-    // first, we'll get a path to the file we'll write to
-    char* file_path = make_task_list_file_path(list->name);
-    if (!file_path) { return 1; }
-    // open the file with write permissions (free and return on failure)
-    FILE* file = fopen(file_path, "w");
-    if (!file)
+    // if saves are deferred, just remember that the list needs saving
+    if (task_list_saves_are_deferred)
     {
-        free(file_path);
-        if (errno) { return errno; }
-        return 1;
+        list->dirty = 1;
+        return 0;
     }
+    return write_task_list(list);
+}
 
-    // get the header string from the task list and write it out
-    char* header = task_list_get_scribe_string(list);
-    fprintf(file, "%s\n", header);
-
-    // iterate through the task list
-    TaskListElem* current = list->head;
-    int i = 0;
-    while (i++ < list->size && current)
-    {
-        // get a task string and write it out to the file
-        char* task_string = task_get_scribe_string(current->task);
-        fprintf(file, "%s\n", task_string);
-        free(task_string);
+void defer_task_list_saves(int defer)
+{ task_list_saves_are_deferred = defer != 0; }
 
-        // increment pointer
-        current = current->next;
-    }
+int task_list_saves_deferred()
+{ return task_list_saves_are_deferred; }
 
-    // free memory and close the file pointer
-    fclose(file);
-    free(header);
-    free(file_path);
-    return 0;
+int save_task_list_if_dirty(TaskList* list)
+{
+    if (!list) { return 1; }
+    return list->dirty ? write_task_list(list) : 0;
 }
 
 // Takes in the name of a TaskList and attempts to load it in from disk.
@@ -88,41 +87,61 @@ TaskList* load_task_list(char* name)
         return NULL;
     }
 
-    // determine a maximum line length to read
-    size_t max_line_length = TASK_LIST_NAME_MAX_LENGTH + TASK_TITLE_MAX_LENGTH +
-                             TASK_DESCRIPTION_MAX_LENGTH + 32;
-
-    // read the first line - this should be the header string.
-    // on failure, free all and return
-    char* buffer = calloc(max_line_length + 1, sizeof(char));
-    size_t read_amount = getline(&buffer, &max_line_length, file);
-    if (read_amount <= 0)
+    // stat the file - we'll need this to check the list's journal
+    struct stat stats;
+    if (fstat(fileno(file), &stats))
     {
         free(file_path);
-        free(buffer);
         fclose(file);
+        return NULL;
     }
-    TaskList* list = task_list_new_from_scribe_string(buffer);
 
-    // iterate through the remaining lines and interpret them as tasks
-    while (getline(&buffer, &max_line_length, file) > 0)
-    {
-        // if there's a '\n' at the end of the string, replace it with
-        // a string terminator
-        char* newline = strstr(buffer, "\n");
-        if (newline) { *newline = '\0'; }
-        // attempt to convert the string into a Task object. If one was
-        // successfully created, add it to the task list
-        Task* task = task_new_from_scribe_string(buffer);
-        if (task)
-        { task_list_append(list, task); }
-    }
+    // look at the beginning of the file to determine its format. Binary
+    // files are mapped, and text files are parsed
+    char magic[TASKBIN_MAGIC_LENGTH] = {'\0'};
+    size_t magic_length = fread(magic, 1, TASKBIN_MAGIC_LENGTH, file);
+    rewind(file);
+    TaskList* list = NULL;
+    if (taskbin_is_binary(magic, magic_length))
+    { list = load_binary_task_list(file, &stats); }
+    else if (magic_length > 0 && magic[0] == '#')
+    { list = load_text_task_list(file, &stats); }
+    else
+    { list = load_text_task_list_v1(file, &stats); }
+
+    // apply any changes recorded in the list's journal since the file was
+    // last written
+    if (list) { journal_replay(list, name, &stats); }
 
     // close the file and free memory
     fclose(file);
     free(file_path);
-    free(buffer);
+    return list;
+}
+
+TaskList* load_task_list_from_buffer(char* name, char* buffer, size_t length,
+                                     struct stat* stats)
+{
+    if (!name || !buffer || !stats) { return NULL; }
+
+    // binary lists are mapped (so their tasks can point into the file), rather
+    // than built from a copy
+    TaskList* list = NULL;
+    if (taskbin_is_binary(buffer, length))
+    { return NULL; }
+    else if (length > 0 && buffer[0] == '#')
+    { list = parse_text_task_list(buffer, length); }
+    else
+    {
+        // the old format is parsed line by line, straight from the buffer
+        FILE* file = fmemopen(buffer, length, "r");
+        if (!file) { return NULL; }
+        list = load_text_task_list_v1(file, stats);
+        fclose(file);
+    }
 
+    // apply the list's journal, just like 'load_task_list'
+    if (list) { journal_replay(list, name, stats); }
     return list;
 }
 
@@ -134,11 +153,17 @@ int delete_task_list(TaskList* list)
     char* file_path = make_task_list_file_path(list->name);
     if (!file_path) { return 1; }
 
-    // attempt to delete the file. Return the error code on failure
+    // attempt to delete the file. Return the error code on failure. (If the
+    // file doesn't exist, there's nothing to delete: a list created while
+    // saves were deferred may never have been written)
     errno = 0;
     int result = remove(file_path);
-    if (result < 0 || errno)
-    { return errno; }
+    if (result < 0 && errno != ENOENT)
+    {
+        free(file_path);
+        return errno;
+    }
+    journal_delete(list->name);
 
     // free the file path and return 0
     free(file_path);
@@ -155,10 +180,7 @@ int count_saved_task_lists(char*** list_names)
     // attempt to open the home directory for reading
     DIR* dir = opendir(home);
     if (!dir)
-    {
-        free(home);
-        return 1;
-    }
+    { return 1; }
 
     // allocate an array of strings and iterate through the array again to
     // copy each file name. We'll start with a set array capacity and realloc
@@ -203,20 +225,38 @@ int count_saved_task_lists(char*** list_names)
     return tasklist_count;
 }
 
+char* task_list_file_name(char* name)
+{
+    // check for a NULL pointer
+    if (!name) { return NULL; }
+
+    // calculate the correct length to use for the name, then format it
+    int name_length = strlen(name);
+    if (name_length > TASK_LIST_NAME_MAX_LENGTH)
+    { name_length = TASK_LIST_NAME_MAX_LENGTH; }
+    return format_string_for_file_name(name, name_length);
+}
+
 
-// =========================== Helper Functions ============================ //
 // Uses the $HOME environment variable to build a string path to ttydo's home
 // directory. (located at: ~/.ttydo/)
 char* get_home_directory()
 {
-    // check to see if the home directory has already been initialized.
-    // if so, simply return the string and avoid the expensive operations below
-    if (strlen(ttydo_home_dir))
-    { return ttydo_home_dir; }
+    // the path is only built once (even if several threads ask for it at the
+    // same time). After that, the string is simply returned
+    pthread_once(&ttydo_home_dir_once, init_home_directory);
+    if (!strlen(ttydo_home_dir))
+    { return NULL; }
+    return ttydo_home_dir;
+}
 
-    // retrieve the environment variable. If it fails, return NULL
+// Builds the path returned by 'get_home_directory' (and creates the directory
+// if it doesn't exist). If $HOME isn't set, the path is left empty.
+void init_home_directory()
+{
+    // retrieve the environment variable. If it fails, return
     char* home = getenv("HOME");
-    if (!home) { return NULL; }
+    if (!home) { return; }
     int home_length = strlen(home);
     
     // make and get the length of the .ttydo folder string
@@ -239,12 +279,8 @@ char* get_home_directory()
                     " Try creating the directory manually.\n", ttydo_home_dir);
         }
     }
-
-    return ttydo_home_dir;
 }
 
-// Takes in the name of a task list and creates a file to which it will be
-// saved to and restored from. The returned string is dynamically allocated.
 char* make_task_list_file_path(char* name)
 {
     // check for a NULL pointer
@@ -280,6 +316,300 @@ char* make_task_list_file_path(char* name)
     return result;
 }
 
+
+int write_file_atomically(char* path, char* data, size_t length)
+{
+    if (!path || (!data && length > 0)) { return 1; }
+
+    // create a uniquely-named temporary file next to the destination (it has
+    // to be in the same directory for 'rename' to be atomic). The random
+    // suffix means it'll never be mistaken for a saved task list
+    size_t path_length = strlen(path);
+    char temp_path[path_length + 8];
+    snprintf(temp_path, path_length + 8, "%s.XXXXXX", path);
+    int fd = mkstemp(temp_path);
+    if (fd < 0) { return errno ? errno : 1; }
+    // 'mkstemp' creates the file with 0600 permissions - we'll match what
+    // 'fopen' would have given us instead
+    mode_t mask = umask(0);
+    umask(mask);
+    fchmod(fd, 0666 & ~mask);
+
+    // write the data out. A single 'write' may not write everything (or may
+    // be interrupted by a signal), so we'll loop until it's all out
+    int result = 0;
+    size_t written = 0;
+    while (written < length && !result)
+    {
+        ssize_t count = write(fd, data + written, length - written);
+        if (count < 0 && errno != EINTR)
+        { result = errno ? errno : 1; }
+        else if (count > 0)
+        { written += count; }
+    }
+
+    // flush the file's contents to disk before it replaces the old one, so a
+    // crash can never leave a truncated file under the real name
+    if (!result && fsync(fd)) { result = errno ? errno : 1; }
+    if (close(fd) && !result) { result = errno ? errno : 1; }
+    if (!result && rename(temp_path, path)) { result = errno ? errno : 1; }
+    if (result)
+    {
+        unlink(temp_path);
+        return result;
+    }
+
+    // finally, flush the directory so the rename itself is durable. (Some
+    // file systems don't support this - the file is still intact if so)
+    char dir_path[path_length + 1];
+    snprintf(dir_path, path_length + 1, "%s", path);
+    char* slash = strrchr(dir_path, '/');
+    if (slash)
+    {
+        // cut the path off at the last slash (keeping "/" for the root)
+        if (slash == dir_path) { slash[1] = '\0'; }
+        else { *slash = '\0'; }
+        int dir_fd = open(dir_path, O_RDONLY | O_DIRECTORY);
+        if (dir_fd >= 0)
+        {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+    }
+    return 0;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Writes the given list out to disk, in full. Returns 0 on success and a
+// non-zero value on failure.
+int write_task_list(TaskList* list)
+{
+    // build the entire file's contents in memory (in the list's format), so
+    // it can be written out with as few system calls as possible
+    size_t length = 0;
+    char* buffer = NULL;
+    if (list->format == TASK_LIST_FORMAT_BINARY)
+    { buffer = taskbin_from_task_list(list, &length); }
+    else
+    { buffer = task_list_to_scribe_buffer(list, &length); }
+    if (!buffer) { return 1; }
+
+    // get a path to the file we'll write to, then replace it atomically. The
+    // old version of the file stays intact until the new one is fully on disk
+    char* file_path = make_task_list_file_path(list->name);
+    if (!file_path)
+    {
+        free(buffer);
+        return 1;
+    }
+    int result = write_file_atomically(file_path, buffer, length);
+
+    // the file now holds every change, so the list's journal can be deleted
+    if (!result) { result = journal_delete(list->name); }
+    if (!result) { list->dirty = 0; }
+
+    // free memory and return
+    free(buffer);
+    free(file_path);
+    return result;
+}
+
+// Takes in an open binary task list file and its stats, and maps the file into
+// memory to build a TaskList. The list's tasks point straight into the mapped
+// file, which is unmapped when the list is freed. Returns NULL on failure.
+TaskList* load_binary_task_list(FILE* file, struct stat* stats)
+{
+    if (stats->st_size <= 0) { return NULL; }
+
+    // map the file (it stays mapped even after the file is closed)
+    size_t length = stats->st_size;
+    void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (mapping == MAP_FAILED) { return NULL; }
+
+    // build the list - if that fails, unmap the file
+    TaskList* list = taskbin_to_task_list(mapping, length);
+    if (!list)
+    {
+        munmap(mapping, length);
+        return NULL;
+    }
+    list->mapping = mapping;
+    list->mapping_length = length;
+    return list;
+}
+
+// Takes in a TaskList and builds a single dynamically-allocated string holding
+// everything that's written to the list's file: the header line, followed by
+// one record per task. The string's length is saved to 'length'. On failure,
+// NULL is returned.
+char* task_list_to_scribe_buffer(TaskList* list, size_t* length)
+{
+    // start with a guess at the buffer's size
+    size_t capacity = TASK_LIST_NAME_MAX_LENGTH + 128 + (list->size * 96);
+    char* buffer = malloc(capacity);
+    if (!buffer) { return NULL; }
+
+    // write the header
+    int header_length = task_list_write_scribe_header(list, buffer, capacity);
+    if (header_length < 0 || (size_t) header_length >= capacity)
+    {
+        free(buffer);
+        return NULL;
+    }
+    size_t used = header_length;
+
+    // iterate through the task list
+    for (int i = 0; i < list->size; i++)
+    {
+        // write the task's record straight into the buffer. If it doesn't
+        // fit, grow the buffer and write it again
+        int record_length = task_write_scribe_record(list->tasks[i],
+                                                     buffer + used,
+                                                     capacity - used);
+        if (record_length < 0)
+        {
+            free(buffer);
+            return NULL;
+        }
+        if (used + record_length >= capacity)
+        {
+            while (used + record_length >= capacity)
+            { capacity *= 2; }
+            char* new_buffer = realloc(buffer, capacity);
+            if (!new_buffer)
+            {
+                free(buffer);
+                return NULL;
+            }
+            buffer = new_buffer;
+            task_write_scribe_record(list->tasks[i], buffer + used,
+                                     capacity - used);
+        }
+        used += record_length;
+    }
+
+    *length = used;
+    return buffer;
+}
+
+// Takes in an open text task list file (in the current format) and its stats,
+// and reads the entire file into memory to build a TaskList. Returns NULL on
+// failure.
+TaskList* load_text_task_list(FILE* file, struct stat* stats)
+{
+    // read the whole file at once
+    size_t length = stats->st_size;
+    char* buffer = malloc(length + 1);
+    if (!buffer) { return NULL; }
+    if (fread(buffer, 1, length, file) != length)
+    {
+        free(buffer);
+        return NULL;
+    }
+    buffer[length] = '\0';
+
+    TaskList* list = parse_text_task_list(buffer, length);
+    free(buffer);
+    return list;
+}
+
+// Takes in the contents of a text task list file (in the current format),
+// null-terminated, and builds a TaskList from them. Returns NULL on failure.
+TaskList* parse_text_task_list(char* buffer, size_t length)
+{
+    // parse the header, then one record at a time (the tasks are allocated
+    // from the list's arena)
+    int consumed = 0;
+    TaskList* list = task_list_new_from_scribe_header(buffer, length, &consumed,
+                                                      NULL, NULL);
+    if (list && task_list_new_arena(list, length))
+    {
+        task_list_free(list);
+        list = NULL;
+    }
+    size_t offset = consumed;
+    while (list && offset < length)
+    {
+        Task* task = task_new_from_scribe_record(buffer + offset,
+                                                 length - offset, &consumed,
+                                                 list->arena);
+        if (task)
+        {
+            task_list_append(list, task);
+            offset += consumed;
+            continue;
+        }
+
+        // if a record is malformed, skip to the next line (just like an
+        // unreadable line in the old format)
+        char* newline = memchr(buffer + offset, '\n', length - offset);
+        if (!newline) { break; }
+        offset = (newline + 1) - buffer;
+    }
+    return list;
+}
+
+// Takes in an open text task list file in the old (version 1) format and
+// parses it line by line to build a TaskList. Returns NULL on failure.
+TaskList* load_text_task_list_v1(FILE* file, struct stat* stats)
+{
+    // determine a maximum line length to read
+    size_t max_line_length = TASK_LIST_NAME_MAX_LENGTH + TASK_TITLE_MAX_LENGTH +
+                             TASK_DESCRIPTION_MAX_LENGTH + 32;
+
+    // read the first line - this should be the header string.
+    // on failure, free all and return
+    char* buffer = calloc(max_line_length + 1, sizeof(char));
+    if (!buffer) { return NULL; }
+    ssize_t read_amount = getline(&buffer, &max_line_length, file);
+    TaskList* list = NULL;
+    if (read_amount > 0)
+    { list = task_list_new_from_scribe_string(buffer, NULL, NULL); }
+    if (list && task_list_new_arena(list, stats->st_size))
+    {
+        task_list_free(list);
+        list = NULL;
+    }
+    if (!list)
+    {
+        free(buffer);
+        return NULL;
+    }
+
+    // iterate through the remaining lines and interpret them as tasks
+    ssize_t line_length = 0;
+    while ((line_length = getline(&buffer, &max_line_length, file)) > 0)
+    {
+        // if there's a '\n' at the end of the string, replace it with
+        // a string terminator
+        if (buffer[line_length - 1] == '\n')
+        { buffer[--line_length] = '\0'; }
+        // attempt to convert the line into a Task object (it's parsed right
+        // inside the buffer). If one was created, add it to the task list
+        Task* task = task_new_from_scribe_buffer(buffer, line_length,
+                                                 list->arena);
+        if (task)
+        { task_list_append(list, task); }
+    }
+
+    free(buffer);
+    return list;
+}
+
+// Gives a list that's about to be loaded from a text file (of the given
+// length) an arena to allocate its tasks from. It's sized to hold every task
+// the file could contain, so loading doesn't need to allocate more blocks.
+// Returns 0 on success and a non-zero value on failure.
+int task_list_new_arena(TaskList* list, size_t file_length)
+{
+    // each task's strings are no longer than its line, and there can't be
+    // more tasks than there are minimum-length lines
+    size_t max_tasks = file_length / SCRIBE_MIN_LINE_LENGTH + 1;
+    list->arena = arena_new(file_length + (max_tasks * sizeof(Task)));
+    return list->arena == NULL;
+}
+
 // Takes in a string and its length and creates a new dynamically-allocated
 // string containing a file-name-friendly version of the string
 char* format_string_for_file_name(char* string, int string_length)
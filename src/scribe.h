@@ -7,17 +7,43 @@
 #define SCRIBE_H
 
 // Module inclusions
+#include <sys/stat.h>
 #include "tasklist.h"
 
 // Takes in a pointer to a TaskList and attempts to write it out to disk.
-// Returns 0 on success and a non-zero value on failure.
+// The list's file is replaced atomically: either the old contents or the new
+// contents will be on disk, even if ttydo crashes or the disk fills up partway
+// through. Returns 0 on success and a non-zero value on failure.
 int save_task_list(TaskList* list);
 
+// Turns deferred saving on (if 'defer' is non-zero) or off. While saves are
+// deferred, 'save_task_list' (and recording a change in a list's journal)
+// doesn't write anything: the list is only marked as dirty, so a list that's
+// changed many times in a row can be written out just once, by
+// 'save_task_list_if_dirty'.
+void defer_task_list_saves(int defer);
+
+// Returns non-zero if saves are currently being deferred.
+int task_list_saves_deferred();
+
+// Writes the list out to disk (even if saves are deferred), but only if it
+// has changes that haven't been saved. Returns 0 on success (or if there was
+// nothing to save) and a non-zero value on failure.
+int save_task_list_if_dirty(TaskList* list);
+
 // Takes in the name of a TaskList and attempts to load it in from disk.
 // On success, a dynamically-allocated TaskList pointer is returned. Otherwise,
-// NULL is returned
+// NULL is returned. Different lists may be loaded by several threads at once.
 TaskList* load_task_list(char* name);
 
+// Works just like 'load_task_list', but takes in the contents and stats of the
+// list's file, which the caller has already read into memory (null-terminated).
+// The buffer isn't modified, and can be freed once the list is built. Only
+// text lists can be loaded this way: binary lists are mapped by
+// 'load_task_list' instead (so for those, NULL is returned).
+TaskList* load_task_list_from_buffer(char* name, char* buffer, size_t length,
+                                     struct stat* stats);
+
 // Takes in a TaskList pointer and attempts to delete its file on disk.
 // Returns 0 on success and a non-zero value on failure.
 int delete_task_list(TaskList* list);
@@ -28,4 +54,25 @@ int delete_task_list(TaskList* list);
 // caller).
 int count_saved_task_lists(char*** list_names);
 
+// Returns the path to ttydo's home directory (located at ~/.ttydo), creating
+// the directory if it doesn't exist. The returned string must NOT be freed.
+// On failure, NULL is returned.
+char* get_home_directory();
+
+// Takes in the name of a task list and creates the path of the file to which
+// it will be saved to and restored from. The returned string is dynamically
+// allocated. On failure, NULL is returned.
+char* make_task_list_file_path(char* name);
+
+// Takes in the name of a TaskList and generates the name of the file it's
+// saved to (without the ttydo directory or the '.tasklist' suffix). The
+// returned string is dynamically allocated. On failure, NULL is returned.
+char* task_list_file_name(char* name);
+
+// Takes in a file path and a buffer of data (and its length), and writes the
+// data to a temporary file in the same directory. The temporary file is then
+// flushed to disk and renamed over the given path. Returns 0 on success and a
+// non-zero value on failure (in which case the original file is untouched).
+int write_file_atomically(char* path, char* data, size_t length);
+
 #endif
@@ -8,14 +8,21 @@
 #include <string.h>
 #include <time.h>
 #include <errno.h>
+#include <unistd.h>
 #include "task.h"
+#include "hashindex.h"
 #include "visual/colors.h"
 
 // ================ Defines and Helper Function Prototypes ================= //
 #define TASK_COMMA_SCRIBE_STRING "<COMMA>" // when commas appear in task text
-uint64_t generate_task_id(char* title);
+uint64_t task_id_seed = 0;    // per-process seed for new IDs (0 until set)
+uint64_t task_id_counter = 0; // number of IDs handed out so far
 int count_substring(char* text, int length, char* substring);
-int replace_substring(char** text, int length, char* substring, char* replacement);
+char* next_scribe_token(char** cursor);
+int unescape_scribe_token(char* token);
+Task* task_new_inline(char* title, int title_length, char* desc, int desc_length,
+                      Arena* arena);
+int read_scribe_number(char** cursor, char* end, char delimiter, uint64_t* value);
 
 
 // ============================== Task Struct ============================== //
@@ -65,8 +72,8 @@ Task* task_new(char* title, char* desc)
     }
     else { task->title = NULL; }
 
-    // generate an ID for the task using the task description (string hashing)
-    task->id = generate_task_id(task->description);    
+    // give the task a new ID
+    task->id = task_generate_id();
 
     // set the default color for the task
     task_set_color(task, NULL);
@@ -75,17 +82,84 @@ Task* task_new(char* title, char* desc)
     return task;
 }
 
+Task* task_new_in_arena(char* title, char* desc, Arena* arena)
+{
+    return task_new_with_id(title, desc, task_generate_id(), arena);
+}
+
+Task* task_new_with_id(char* title, char* desc, uint64_t id, Arena* arena)
+{
+    // truncate the strings, just like 'task_new'
+    int title_length = title ? strnlen(title, TASK_TITLE_MAX_LENGTH) : 0;
+    int desc_length = desc ? strnlen(desc, TASK_DESCRIPTION_MAX_LENGTH) : 0;
+    Task* task = task_new_inline(title, title_length, desc, desc_length, arena);
+    if (!task) { return NULL; }
+
+    // set the ID and the default color
+    task->id = id;
+    task_set_color(task, NULL);
+    return task;
+}
+
+uint64_t task_generate_id()
+{
+    // the first time an ID is needed, seed the generator from the clock and
+    // the process ID (if two threads race to do this, the first one wins)
+    uint64_t seed = __atomic_load_n(&task_id_seed, __ATOMIC_ACQUIRE);
+    if (!seed)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        uint64_t fresh = hash_index_integer((now.tv_sec * 1000000000ull) +
+                                            now.tv_nsec +
+                                            ((uint64_t) getpid() << 40)) | 1;
+        if (__atomic_compare_exchange_n(&task_id_seed, &seed, fresh, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        { seed = fresh; }
+    }
+
+    // step a splitmix64 sequence from the seed. The mix is a one-to-one
+    // function, so a process never hands out the same ID twice (0 is skipped,
+    // since it means "no ID")
+    uint64_t id = 0;
+    while (!id)
+    {
+        uint64_t count = __atomic_add_fetch(&task_id_counter, 1, __ATOMIC_RELAXED);
+        id = hash_index_integer(seed + (count * 0x9e3779b97f4a7c15ull));
+    }
+    return id;
+}
+
+Task* task_new_borrowed(char* title, char* desc, Arena* arena)
+{
+    // attempt to allocate, and return NULL on failure
+    Task* task = arena ? arena_alloc(arena, sizeof(Task)) : calloc(1, sizeof(Task));
+    if (!task) { return NULL; }
+
+    // point at the given strings and mark them as borrowed
+    task->title = title;
+    task->description = desc;
+    task->flags = TASK_FLAG_BORROWED_TITLE | TASK_FLAG_BORROWED_DESCRIPTION;
+    if (arena) { task->flags |= TASK_FLAG_ARENA; }
+
+    // set the default color for the task
+    task_set_color(task, NULL);
+    return task;
+}
+
 void task_free(Task* task)
 {
     // if the given pointer is NULL, go no further
     if (!task) { return; }
 
-    // attempt to free the string fields
-    if (task->title) { free(task->title); }
-    if (task->description) { free(task->description); }
+    // attempt to free the string fields (unless they're borrowed)
+    if (task->title && !(task->flags & TASK_FLAG_BORROWED_TITLE))
+    { free(task->title); }
+    if (task->description && !(task->flags & TASK_FLAG_BORROWED_DESCRIPTION))
+    { free(task->description); }
     
-    // free the pointer itself
-    free(task);
+    // free the pointer itself (unless its arena owns it)
+    if (!(task->flags & TASK_FLAG_ARENA)) { free(task); }
 }
 
 char* task_to_string(Task* task)
@@ -93,142 +167,82 @@ char* task_to_string(Task* task)
     // if the pointer is NULL, return NULL
     if (!task) { return NULL; }
 
-    // calculate the lengths of the title and description
-    int title_length = 0;
-    if (task->title) { title_length = strlen(task->title); }
-    int desc_length = 0;
-    if (task->description) { desc_length = strlen(task->description); }
+    // render the task into a fresh buffer, then take the string out of it
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return NULL; }
+    task_render(task, out);
+    return output_buffer_detach(out);
+}
 
-    // allocate a string of the appropriate size
-    int pad = strlen(TASK_DEFAULT_TITLE) + strlen(TASK_DEFAULT_DESCRIPTION) +
-              strlen(C_TASK_CBOX) + strlen(task->color) + (strlen(C_NONE) * 2) + 16;
-    if (task->is_complete)
-    { pad += strlen(C_TASK_CBOX) + strlen(C_TASK_CBOX_DONE); }
-    char* result = calloc(title_length + desc_length + pad, sizeof(char));
-    if (!result) { return NULL; }
-    int result_length = 0;
+void task_render(Task* task, OutputBuffer* out)
+{
+    if (!task || !out) { return; }
+
+    // look up the escape sequence for the task's color
+    const char* color = color_from_index(task->color);
+    if (!color) { color = C_TASK_TITLE; }
 
     // add a "[ ]" or "[X]" to use for a 'task.is_complete' indicator
     if (task->is_complete)
     {
-        result_length += snprintf(result,
-                                  5 + (strlen(C_TASK_CBOX) * 2) + strlen(C_TASK_CBOX_DONE) + strlen(C_NONE),
-                                  C_TASK_CBOX "["
-                                  C_TASK_CBOX_DONE "X"
-                                  C_TASK_CBOX "] " C_NONE);
+        output_string(out, C_TASK_CBOX "["
+                           C_TASK_CBOX_DONE "X"
+                           C_TASK_CBOX "] " C_NONE);
     }
     else
-    {
-        result_length += snprintf(result,
-                                  5 + strlen(C_TASK_CBOX) + strlen(C_NONE),
-                                  C_TASK_CBOX "[ ] " C_NONE);
-    }
+    { output_string(out, C_TASK_CBOX "[ ] " C_NONE); }
 
-    // copy the title in
+    // add the title (in the task's color), then the description
     if (task->title)
     {
-        result_length += snprintf(result + result_length,
-                                  title_length + strlen(task->color) + strlen(C_NONE) + 3,
-                                  "%s%s: " C_NONE, task->color, task->title);
-    }
-    else
-    {
-        result_length += snprintf(result + result_length, strlen(TASK_DEFAULT_TITLE) + 3,
-                                  "%s: ", TASK_DEFAULT_TITLE);
-    }
-
-    // copy the description in
-    if (task->description)
-    {
-        result_length += snprintf(result + result_length, desc_length + 1,
-                                  "%s", task->description);
+        output_string(out, color);
+        output_string(out, task->title);
+        output_string(out, ": " C_NONE);
     }
     else
-    {
-        result_length += snprintf(result + result_length,
-                                  strlen(TASK_DEFAULT_DESCRIPTION) + 1,
-                                  "%s", TASK_DEFAULT_DESCRIPTION);
-    }
-    
-    return result;
+    { output_string(out, TASK_DEFAULT_TITLE ": "); }
+    output_string(out, task->description ? task->description
+                                         : TASK_DEFAULT_DESCRIPTION);
 }
 
-void task_set_color(Task* task, char* name)
+void task_set_title(Task* task, char* title)
 {
-    if (!task)
-    { return; }
-
-    // look for a color string matching the name
-    const char* cstr = color_from_name(name);
+    if (!task) { return; }
 
-    // copy the color string into the task struct
-    if (cstr)
-    { snprintf(task->color, COLOR_MAX_LENGTH, "%s", cstr); }
-    else
-    { snprintf(task->color, COLOR_MAX_LENGTH, "%s", C_TASK_TITLE); }
+    // make the copy first, then release the old title (if we own it)
+    char* copy = title ? strdup(title) : NULL;
+    if (title && !copy) { return; }
+    if (task->title && !(task->flags & TASK_FLAG_BORROWED_TITLE))
+    { free(task->title); }
+    task->title = copy;
+    task->flags &= ~TASK_FLAG_BORROWED_TITLE;
 }
 
-
-// =========================== Helper Functions ============================ //
-// Takes in the description of a task and uses a string-folding hash algorithm
-// to generate a unique ID for a task. On failure, 0 is returned.
-// I found this algorithm here:
-// http://research.cs.vt.edu/AVresearch/hashing/strings.php
-uint64_t generate_task_id(char* description)
+void task_set_description(Task* task, char* desc)
 {
-    // make a local copy of the string with extra room
-    int filled_length = 0;
-    int string_length = 64;
-    int salt_length = 16;
-    if (description) { string_length = strlen(description); }
-    char local[string_length + salt_length + 1];
-    memset(local, 0, string_length + salt_length + 1);
-    // if we were given a string, copy it in
-    if (description)
-    {
-        snprintf(local, string_length + 1, "%s", description);
-        filled_length = string_length;
-    }
-
-    // use 'filled_length'  to fill the remaining characters with random
-    // gibberish. This will act as either a salt onto the given string, or
-    // a completely random string for when 'description' is NULL.
-    static int task_id_random_seeder = 0;
-    srand(time(NULL) + task_id_random_seeder++);
-    for (int i = filled_length; i < string_length + salt_length; i++)
-    { local[i] = (char) ((rand() % 96) + 32); }
-
-    int length = strlen(local) / 4;
-    uint64_t sum = 0;
-    // iterate through the strings characters
-    for (int i = 0; i < length; i++)
-    {
-        // get a substring of characters
-        char sub[5];
-        snprintf(sub, 5, "%s", local + (i * 4));
+    if (!task) { return; }
 
-        uint64_t multiplier = 1;
-        for (int j = 0; j < strlen(sub); j++)
-        {
-            sum += sub[j] * multiplier;
-            multiplier *= 256;
-        }
-    }
+    // make the copy first, then release the old description (if we own it)
+    char* copy = desc ? strdup(desc) : NULL;
+    if (desc && !copy) { return; }
+    if (task->description && !(task->flags & TASK_FLAG_BORROWED_DESCRIPTION))
+    { free(task->description); }
+    task->description = copy;
+    task->flags &= ~TASK_FLAG_BORROWED_DESCRIPTION;
+}
 
-    // for the remaining characters: perform the same action
-    char sub[5];
-    snprintf(sub, 5, "%s", local + (length * 4));
-    uint64_t multiplier = 1;
-    for (int i = 0; i < strlen(sub); i++)
-    {
-        sum += sub[i] * multiplier;
-        multiplier *= 256;
-    }
+void task_set_color(Task* task, char* name)
+{
+    if (!task)
+    { return; }
 
-    // return the resulting integer
-    return sum;
+    // look for a color matching the name (or use the default)
+    int index = color_index_from_name(name);
+    task->color = index >= 0 ? index : COLOR_INDEX_TASK_TITLE;
 }
 
+
+// =========================== Helper Functions ============================ //
 // Counts the number of substrings in the given text.
 int count_substring(char* text, int length, char* substring)
 {
@@ -247,225 +261,280 @@ int count_substring(char* text, int length, char* substring)
     return sub_occurrences;
 }
 
-// Helper function for scribe string generation that takes in some dynamically-
-// -allocated text, its length, a substring, and a replacement string, and
-// replaces all occurrences of 'substring' with 'replacement', reallocing if
-// necessary. The new string length is returned.
-int replace_substring(char** text, int length, char* substring, char* replacement)
-{
-    // get the length of the two string args
-    int sub_length = strlen(substring);
-    int rep_length = strlen(replacement);
-
-    // count the occurrences of the substring in the string
-    int sub_occurrences = count_substring(*text, length, substring);
-
-    // if there are no occurrences, just return the same length
-    if (sub_occurrences == 0)
-    { return length; }
-    
-    // otherwise, make a local copy of the string
-    char temp[length + 1];
-    snprintf(temp, length + 1, "%s", *text);
-
-    // use the amount of substrings to determine the new length of the string
-    // (reallocate if necessary)
-    int new_length = length + (sub_occurrences * (rep_length - sub_length));
-    if (new_length > length)
-    { *text = realloc(*text, (new_length + 1) * sizeof(char)); }
-
-    // copy each character in from the temporary copy
-    char* c1 = *text;
-    char* c2 = temp;
-    for (int i = 0; i < length && c1 < *text + new_length; i++)
-    {
-        // if the current location of the text contains the substring, we'll
-        // instead write the replacement
-        if (!strncmp(c2, substring, sub_length))
-        {
-            snprintf(c1, rep_length + 1, "%s", replacement);
-            c1 += rep_length;
-            c2 += sub_length;
-            continue;
-        }
-
-        // otherwise, we'll just copy the current byte and move to the next
-        *(c1++) = *(c2++);
-    }
-    *c1 = '\0';
-
-    return new_length;
-}
-
 
 // ========================== File String Parsing ========================== //
-char* task_get_scribe_string(Task* task)
+Task* task_new_from_scribe_string(char* string)
 {
-    // check for a NULL pointer, or a NULL title
-    if (!task) { return NULL; }
-
-    // if no title is given, use the default string
-    if (!task->title)
-    {
-        int length = strlen(TASK_DEFAULT_TITLE);
-        task->title = calloc(length + 1, sizeof(char));
-        snprintf(task->title, length + 1, "%s", TASK_DEFAULT_TITLE);
-    }
-    // if no description is given, use the default string
-    if (!task->description)
-    {
-        int length = strlen(TASK_DEFAULT_DESCRIPTION);
-        task->description = calloc(length + 1, sizeof(char));
-        snprintf(task->description, length + 1, "%s", TASK_DEFAULT_DESCRIPTION);
-    }
-
-    // convert the task's ID to a string
-    int id_string_max_length = 24;
-    char id_string[id_string_max_length];
-    snprintf(id_string, id_string_max_length, "%lu", task->id);
-
-    // convert the task's 'is_complete' to a string
-    int complete_string_max_length = 2;
-    char complete_string[complete_string_max_length];
-    snprintf(complete_string, complete_string_max_length, "%d",
-            task->is_complete != 0);
-    
-    // convert the task's color to a name string
-    int color_string_max_length = COLOR_NAME_MAX_LENGTH;
-    char color_string[color_string_max_length];
-    const char* color_name = color_to_name(task->color);
-    snprintf(color_string, color_string_max_length, "%s", color_name);
-
-    // calculate the lengths of strings
-    int id_length = strlen(id_string);
-    int complete_length = strlen(complete_string);
-    int title_length = strlen(task->title);
-    int desc_length = strlen(task->description);
-    int color_length = strlen(color_string);
-
-    // adjust the lengths of the title and description to fit their maximum
-    // length bounds (TASK_TITLE_MAX_LENGTH, TASK_DESCRIPTION_MAX_LENGTH)
-    if (task->title && title_length > TASK_TITLE_MAX_LENGTH)
-    {
-        title_length = TASK_TITLE_MAX_LENGTH;
-        task->title = realloc(task->title, (title_length + 1) * sizeof(char));
-        task->title[title_length] = '\0';
-    }
-    if (task->description && desc_length > TASK_DESCRIPTION_MAX_LENGTH)
-    {
-        desc_length = TASK_DESCRIPTION_MAX_LENGTH;
-        task->description = realloc(task->description, (desc_length + 1) * sizeof(char));
-        task->description[desc_length] = '\0';
-    }
+    // check for a NULL string pointer
+    if (!string) { return NULL; }
 
-    // first, we'll replace the commas with our comma marker in the strings
-    title_length = replace_substring(&task->title, title_length, ",",
-                                     TASK_COMMA_SCRIBE_STRING);
-    desc_length = replace_substring(&task->description, desc_length, ",",
-                                    TASK_COMMA_SCRIBE_STRING);
-    // compute the total length
-    int total_length = id_length + complete_length + title_length +
-                       desc_length + color_length;
-
-    // allocate a new string
-    int safety_pad = 16;
-    char* result = calloc(total_length + safety_pad, sizeof(char));
-    snprintf(result, total_length + safety_pad, "%s,%s,%s,%s,%s", id_string,
-             complete_string, task->title, task->description, color_string);
+    // the buffer parser modifies the string it's given, so we'll hand it a
+    // copy
+    char* copy = strdup(string);
+    if (!copy) { return NULL; }
+    Task* result = task_new_from_scribe_buffer(copy, strlen(copy), NULL);
+    free(copy);
     return result;
 }
 
-Task* task_new_from_scribe_string(char* string)
+Task* task_new_from_scribe_buffer(char* buffer, int length, Arena* arena)
 {
-    // check for a NULL string pointer
-    if (!string) { return NULL; }
+    // check for a NULL buffer pointer
+    if (!buffer) { return NULL; }
 
     // first, count the number of <COMMA> markers in the text (we don't count
     // these as part of the enforced max lengths, since they're used to replace
     // commas entered by the user)
-    int length = strlen(string);
-    int comma_marker_count = count_substring(string, length, TASK_COMMA_SCRIBE_STRING);
+    int marker_length = strlen(TASK_COMMA_SCRIBE_STRING);
+    int comma_marker_count = count_substring(buffer, length, TASK_COMMA_SCRIBE_STRING);
 
     // This string is likely coming straight from a file. To be safe, we need
     // to impose a maximum length the string can have.
     int max_length = TASK_TITLE_MAX_LENGTH + TASK_DESCRIPTION_MAX_LENGTH + 32 +
-                     (comma_marker_count * (strlen(TASK_COMMA_SCRIBE_STRING) - 1));
+                     (comma_marker_count * (marker_length - 1));
     if (length > max_length) { length = max_length; }
+    buffer[length] = '\0';
 
-    // make a local copy of the string of the correct length
-    char local[length + 1];
-    snprintf(local, length + 1, "%s", string);
-    
-    // from here, we'll collect each comma-separated value, one at a time, to
-    // build a new Task struct
+    // from here, we'll split the comma-separated values apart in the buffer
+    // itself (runs of commas count as one separator, just like 'strtok')
     errno = 0;
+    char* cursor = buffer;
     // ---------- PIECE 1: Task ID ---------- //
-    char* id_string = strtok(local, ",");
+    char* id_string = next_scribe_token(&cursor);
     if (!id_string) { return NULL; }
     // attempt to extract the 64-bit integer
     char* end = NULL;
-    uint64_t id = strtol(id_string, &end, 10);
+    uint64_t id = strtoull(id_string, &end, 10);
     if (errno) { return NULL; }
-    
+
     // ---------- PIECE 2: is_complete ---------- //
-    char* complete_string = strtok(NULL, ",");
+    char* complete_string = next_scribe_token(&cursor);
     if (!complete_string) { return NULL; }
     // attempt to extract the integer
     uint8_t is_complete = strtol(complete_string, &end, 10);
     if (errno) { return NULL; }
-    
+
     // ---------- PIECE 3: title ---------- //
     // this may or may not be NULL, if the string given was too short.
     // if it IS NULL, we'll keep it, since we can initialize a Task with a
-    // NULL title
-    char* title = strtok(NULL, ",");
+    // NULL title. Otherwise, we'll swap any comma markers for actual commas
+    char* title = next_scribe_token(&cursor);
+    int title_length = 0;
     if (title)
     {
-        // make a heap-allocated copy and use it to replace any comma markers
-        // with actual commas
-        title = strdup(title);
-        replace_substring(&title, strlen(title),
-                          TASK_COMMA_SCRIBE_STRING, ",");
+        title_length = unescape_scribe_token(title);
+        if (title_length > TASK_TITLE_MAX_LENGTH)
+        { title_length = TASK_TITLE_MAX_LENGTH; }
     }
-    
+
     // ---------- PIECE 4: description ---------- //
     // the same goes for the description as it does for the title: if it's
     // NULL, we'll keep the NULL value.
-    char* description = strtok(NULL, ",");
+    char* description = next_scribe_token(&cursor);
+    int desc_length = 0;
     if (description)
     {
-        // make a heap-allocated copy and use it to replace any comma markers
-        // with actual commas
-        description = strdup(description);
-        replace_substring(&description, strlen(description),
-                          TASK_COMMA_SCRIBE_STRING, ",");
+        desc_length = unescape_scribe_token(description);
+        if (desc_length > TASK_DESCRIPTION_MAX_LENGTH)
+        { desc_length = TASK_DESCRIPTION_MAX_LENGTH; }
     }
 
     // ------------- PIECE 5: color ------------- //
-    char* color = strtok(NULL, ",");
-
-    // create a new Task* struct and free strings as necessary
-    Task* result = task_new(title, description);
-    if (color) { task_set_color(result, color); }
-    if (title) { free(title); }
-    if (description) { free(description); }
+    char* color = next_scribe_token(&cursor);
 
-    // if creating the task failed, return NULL
+    // create the task, with its strings stored in the same allocation
+    Task* result = task_new_inline(title, title_length, description,
+                                   desc_length, arena);
     if (!result) { return NULL; }
 
-    // override the ID field (in case it was generated differently) and set
-    // the 'is_complete' field
+    // set the remaining fields
+    task_set_color(result, color);
     result->id = id;
     result->is_complete = is_complete;
-    
-    // printf("Found ID: %lu\n", result->id);
-    // printf("Complete? %d\n", result->is_complete);
-    // printf("Title:    '%s'\n", result->title);
-    // printf("Desc:     '%s'\n\n", result->description);
+    return result;
+}
 
-    // char* str = task_to_string(result);
-    // printf("Task created:%s\n", str);
-    // if (str) { free(str); }
+int task_write_scribe_record(Task* task, char* buffer, int capacity)
+{
+    if (!task) { return -1; }
+
+    // gather the fields (truncating the strings to their maximum lengths)
+    char* title = task->title ? task->title : TASK_DEFAULT_TITLE;
+    char* desc = task->description ? task->description : TASK_DEFAULT_DESCRIPTION;
+    int title_length = strnlen(title, TASK_TITLE_MAX_LENGTH);
+    int desc_length = strnlen(desc, TASK_DESCRIPTION_MAX_LENGTH);
+    const char* color_name = color_name_from_index(task->color);
+    if (!color_name) { color_name = ""; }
+
+    // build the fixed part of the record, then figure out the total length
+    char prefix[COLOR_NAME_MAX_LENGTH + 96];
+    int prefix_length = snprintf(prefix, COLOR_NAME_MAX_LENGTH + 96,
+                                 "%lu,%d,%s,%d,%d:", task->id,
+                                 task->is_complete != 0, color_name,
+                                 title_length, desc_length);
+    int total_length = prefix_length + title_length + desc_length + 1;
+
+    // if it fits, copy everything in (the strings are copied as-is)
+    if (buffer && total_length < capacity)
+    {
+        memcpy(buffer, prefix, prefix_length);
+        memcpy(buffer + prefix_length, title, title_length);
+        memcpy(buffer + prefix_length + title_length, desc, desc_length);
+        buffer[total_length - 1] = '\n';
+        buffer[total_length] = '\0';
+    }
+    return total_length;
+}
 
+Task* task_new_from_scribe_record(char* buffer, int length, int* consumed,
+                                  Arena* arena)
+{
+    if (!buffer || length <= 0) { return NULL; }
+    char* cursor = buffer;
+    char* end = buffer + length;
+
+    // read the ID and the 'is_complete' flag
+    uint64_t id = 0;
+    uint64_t is_complete = 0;
+    if (read_scribe_number(&cursor, end, ',', &id) ||
+        read_scribe_number(&cursor, end, ',', &is_complete))
+    { return NULL; }
+
+    // the color name runs up to the next comma
+    char* color = cursor;
+    while (cursor < end && *cursor != ',') { cursor++; }
+    if (cursor == end || cursor - color >= COLOR_NAME_MAX_LENGTH)
+    { return NULL; }
+    char color_name[COLOR_NAME_MAX_LENGTH];
+    memcpy(color_name, color, cursor - color);
+    color_name[cursor - color] = '\0';
+    cursor++;
+
+    // read the string lengths, then make sure the strings (and the newline
+    // after them) are all there
+    uint64_t title_length = 0;
+    uint64_t desc_length = 0;
+    if (read_scribe_number(&cursor, end, ',', &title_length) ||
+        read_scribe_number(&cursor, end, ':', &desc_length) ||
+        title_length + desc_length >= (uint64_t) (end - cursor) ||
+        cursor[title_length + desc_length] != '\n')
+    { return NULL; }
+    char* title = cursor;
+    char* desc = cursor + title_length;
+    *consumed = (desc + desc_length + 1) - buffer;
+
+    // create the task (its strings are stored in the same allocation)
+    if (title_length > TASK_TITLE_MAX_LENGTH)
+    { title_length = TASK_TITLE_MAX_LENGTH; }
+    if (desc_length > TASK_DESCRIPTION_MAX_LENGTH)
+    { desc_length = TASK_DESCRIPTION_MAX_LENGTH; }
+    Task* result = task_new_inline(title, title_length, desc, desc_length,
+                                   arena);
+    if (!result) { return NULL; }
+    task_set_color(result, color_name[0] ? color_name : NULL);
+    result->id = id;
+    result->is_complete = is_complete != 0;
     return result;
 }
+
+// Takes in a pointer to a position within a scribe string and returns the
+// next comma-separated token, terminating it in place. The position is moved
+// past the token. Like 'strtok', empty tokens are skipped. Once there are no
+// tokens left, NULL is returned.
+char* next_scribe_token(char** cursor)
+{
+    // skip past any leading commas
+    char* token = *cursor;
+    while (*token == ',') { token++; }
+    if (*token == '\0')
+    {
+        *cursor = token;
+        return NULL;
+    }
+
+    // find the end of the token and terminate it
+    char* end = strchr(token, ',');
+    if (end)
+    {
+        *end = '\0';
+        *cursor = end + 1;
+    }
+    else
+    { *cursor = token + strlen(token); }
+    return token;
+}
+
+// Takes in a scribe token and, in a single pass, replaces every comma marker
+// with an actual comma. The token is modified in place (it can only shrink).
+// Returns the token's new length.
+int unescape_scribe_token(char* token)
+{
+    int marker_length = strlen(TASK_COMMA_SCRIBE_STRING);
+    char* read = token;
+    char* write = token;
+    while (*read)
+    {
+        if (*read == TASK_COMMA_SCRIBE_STRING[0] &&
+            !strncmp(read, TASK_COMMA_SCRIBE_STRING, marker_length))
+        {
+            *(write++) = ',';
+            read += marker_length;
+            continue;
+        }
+        *(write++) = *(read++);
+    }
+    *write = '\0';
+    return write - token;
+}
+
+// Creates a new task whose title and description (either of which may be
+// NULL) are stored right after the Task struct, in the same allocation (from
+// the given arena, or the heap if it's NULL). The strings are copied with the
+// given lengths. Returns NULL on failure.
+Task* task_new_inline(char* title, int title_length, char* desc, int desc_length,
+                      Arena* arena)
+{
+    size_t strings_length = (title ? title_length + 1 : 0) +
+                            (desc ? desc_length + 1 : 0);
+    size_t size = sizeof(Task) + strings_length;
+    Task* task = arena ? arena_alloc(arena, size) : calloc(1, size);
+    if (!task) { return NULL; }
+
+    // copy the strings in (calloc already null-terminated them)
+    char* strings = (char*) (task + 1);
+    if (title)
+    {
+        memcpy(strings, title, title_length);
+        task->title = strings;
+        strings += title_length + 1;
+    }
+    if (desc)
+    {
+        memcpy(strings, desc, desc_length);
+        task->description = strings;
+    }
+    task->flags = TASK_FLAG_BORROWED_TITLE | TASK_FLAG_BORROWED_DESCRIPTION;
+    if (arena) { task->flags |= TASK_FLAG_ARENA; }
+    return task;
+}
+
+// Reads an unsigned decimal number from the cursor, which must be followed by
+// the given delimiter (and must not run past 'end'). The cursor is moved past
+// the delimiter. Returns 0 on success and a non-zero value on failure.
+int read_scribe_number(char** cursor, char* end, char delimiter, uint64_t* value)
+{
+    char* c = *cursor;
+    uint64_t result = 0;
+    int digits = 0;
+    while (c < end && *c >= '0' && *c <= '9' && digits < 20)
+    {
+        result = (result * 10) + (*c - '0');
+        c++;
+        digits++;
+    }
+    if (digits == 0 || c == end || *c != delimiter) { return 1; }
+
+    *value = result;
+    *cursor = c + 1;
+    return 0;
+}
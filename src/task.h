@@ -9,6 +9,8 @@
 // Module inclusions
 #include <inttypes.h>
 #include "visual/colors.h"
+#include "visual/output.h"
+#include "arena.h"
 
 // ========================= Constants and Macros ========================== //
 #define TASK_TITLE_MAX_LENGTH 32    // max number of chars in a title
@@ -18,6 +20,15 @@
 #define TASK_DEFAULT_TITLE "(no title)"
 #define TASK_DEFAULT_DESCRIPTION "(no description)"
 
+// task flags: set when a task's strings weren't allocated on their own (they
+// point into a memory-mapped list file, or into the task's own allocation), so
+// they must not be freed separately
+#define TASK_FLAG_BORROWED_TITLE 0x1
+#define TASK_FLAG_BORROWED_DESCRIPTION 0x2
+// set when the Task struct itself was allocated from a TaskList's arena, so
+// it's released along with the arena rather than freed on its own
+#define TASK_FLAG_ARENA 0x4
+
 
 // ============================== Task Struct ============================== //
 typedef struct _Task
@@ -26,7 +37,8 @@ typedef struct _Task
     char* description;              // the description of the task
     uint64_t id;                    // unique task ID
     uint8_t is_complete;            // whether or not the task is finished
-    char color[COLOR_MAX_LENGTH];   // color string
+    uint8_t flags;                  // TASK_FLAG_* bits
+    uint8_t color;                  // color (palette index, see colors.h)
 } Task;
 
 // Constructor: dynamically allocates memory for a new 'Task' struct, and
@@ -37,10 +49,39 @@ typedef struct _Task
 // is truncated to hold the only TASK_TITLE_MAX_LENGTH characters.
 Task* task_new(char* title, char* desc);
 
+// Works like 'task_new', but the task (and its copies of the strings) are
+// allocated from the given arena, in a single allocation. If the arena is
+// NULL, the task is allocated from the heap instead.
+Task* task_new_in_arena(char* title, char* desc, Arena* arena);
+
+// Works like 'task_new_in_arena', but the task is given the ID of a task that
+// already exists (such as one being loaded from disk), rather than a new one.
+Task* task_new_with_id(char* title, char* desc, uint64_t id, Arena* arena);
+
+// Returns a new task ID (never 0). IDs come from a counter, seeded once per
+// process and mixed through a 64-bit hash, so one process never hands out the
+// same ID twice. Tasks saved by other runs could still share it, so callers
+// adding a task to a list should check the list for it first.
+uint64_t task_generate_id();
+
+// Constructor: allocates a new 'Task' struct (from the given arena, or the
+// heap if it's NULL) whose title and description point to the given strings,
+// rather than copies of them. The strings are never freed by the task, so they
+// must outlive it. The task's ID is left as 0. If allocation fails, NULL is
+// returned.
+Task* task_new_borrowed(char* title, char* desc, Arena* arena);
+
 // Destructor: takes in a pointer to a 'Task' struct and attempts to free the
-// struct's memory.
+// struct's memory. Strings the task owns are freed, but if the struct came
+// from an arena, it's left for the arena to release.
 void task_free(Task* task);
 
+// Replaces the task's title with a copy of the given string.
+void task_set_title(Task* task, char* title);
+
+// Replaces the task's description with a copy of the given string.
+void task_set_description(Task* task, char* desc);
+
 // Sets the task's color string. If the pointer is NULL, the default color is
 // used instead.
 void task_set_color(Task* task, char* name);
@@ -50,14 +91,44 @@ void task_set_color(Task* task, char* name);
 // On failure, NULL is returned.
 char* task_to_string(Task* task);
 
+// Works like 'task_to_string', but renders the task into the given output
+// buffer instead.
+void task_render(Task* task, OutputBuffer* out);
+
 
 // ========================== File String Parsing ========================== //
-// Takes in a pointer to a task and generates a string used by the scribe to
-// write a TaskList out to a file. Returns NULL on failure.
-char* task_get_scribe_string(Task* task);
+// Tasks are saved as records (version 2 of the file format), with the lengths
+// of the title and description stored up front, so they're copied as-is:
+//
+//      <id>,<is_complete>,<color name>,<title length>,<desc length>:<title><desc>
+//
+// Takes in a task and writes its record (followed by a newline) into the
+// given buffer, if it has room for the record and a null terminator. Either
+// way, the record's length is returned (like 'snprintf'), or -1 on failure.
+int task_write_scribe_record(Task* task, char* buffer, int capacity);
 
-// Takes in a header string (generated by 'task_get_scribe_string') and tries
-// to create a new Task struct with its information. Returns NULL on failure.
+// Takes in a buffer (and its length) that begins with a task record, and
+// creates a new Task from it. The number of bytes the record took up
+// (including its newline) is saved to 'consumed'. The task's title and
+// description are stored in the same allocation as the task itself, which
+// comes from the given arena (or the heap, if it's NULL). Returns NULL on
+// failure (or if the record is malformed).
+Task* task_new_from_scribe_record(char* buffer, int length, int* consumed,
+                                  Arena* arena);
+
+// Version 1 of the format separated fields with commas, and replaced any
+// commas within the title and description with a marker. Lists in that
+// format can still be read (but are saved in the current one).
+//
+// Takes in a version 1 task string and tries to create a new Task struct with
+// its information. Returns NULL on failure.
 Task* task_new_from_scribe_string(char* string);
 
+// Works like 'task_new_from_scribe_string', but parses the given buffer (of
+// the given length) in place, without copying it first. The buffer's contents
+// are modified. The task's title and description are stored in the same
+// allocation as the task itself, which comes from the given arena (or the
+// heap, if it's NULL). Returns NULL on failure.
+Task* task_new_from_scribe_buffer(char* buffer, int length, Arena* arena);
+
 #endif
@@ -0,0 +1,178 @@
+// This module implements taskbin.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "taskbin.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+int taskbin_string_is_valid(char* heap, uint32_t heap_size, uint32_t offset,
+                            uint32_t length);
+uint32_t taskbin_heap_add(char* heap, uint32_t* heap_used, char* string,
+                          uint32_t length);
+
+
+// ========================== Conversion Functions ========================= //
+int taskbin_is_binary(char* data, size_t length)
+{
+    return data && length >= TASKBIN_MAGIC_LENGTH &&
+           !memcmp(data, TASKBIN_MAGIC, TASKBIN_MAGIC_LENGTH);
+}
+
+char* taskbin_from_task_list(TaskList* list, size_t* length)
+{
+    if (!list || !list->name || !length) { return NULL; }
+
+    // first, add up the size of the string heap (every string is truncated to
+    // its maximum length, just like the text format)
+    uint32_t name_length = strlen(list->name);
+    size_t heap_size = name_length + 1;
+    int count = list->size;
+    for (int i = 0; i < count; i++)
+    {
+        Task* task = list->tasks[i];
+        heap_size += strnlen(task->title ? task->title : TASK_DEFAULT_TITLE,
+                             TASK_TITLE_MAX_LENGTH) + 1;
+        heap_size += strnlen(task->description ? task->description :
+                             TASK_DEFAULT_DESCRIPTION,
+                             TASK_DESCRIPTION_MAX_LENGTH) + 1;
+    }
+
+    // allocate the entire file at once
+    size_t records_size = count * sizeof(TaskBinRecord);
+    size_t total_size = sizeof(TaskBinHeader) + records_size + heap_size;
+    if (heap_size > UINT32_MAX) { return NULL; }
+    char* result = calloc(total_size, sizeof(char));
+    if (!result) { return NULL; }
+    TaskBinHeader* header = (TaskBinHeader*) result;
+    TaskBinRecord* records = (TaskBinRecord*) (result + sizeof(TaskBinHeader));
+    char* heap = result + sizeof(TaskBinHeader) + records_size;
+    uint32_t heap_used = 0;
+
+    // fill in the header
+    memcpy(header->magic, TASKBIN_MAGIC, TASKBIN_MAGIC_LENGTH);
+    header->byte_order = TASKBIN_BYTE_ORDER;
+    header->version = TASKBIN_VERSION;
+    header->header_size = sizeof(TaskBinHeader);
+    header->record_size = sizeof(TaskBinRecord);
+    header->task_count = count;
+    header->name_length = name_length;
+    header->name_offset = taskbin_heap_add(heap, &heap_used, list->name,
+                                           name_length);
+    header->heap_size = heap_size;
+    header->color = list->color;
+
+    // fill in one record per task
+    for (int i = 0; i < count; i++)
+    {
+        Task* task = list->tasks[i];
+        char* title = task->title ? task->title : TASK_DEFAULT_TITLE;
+        char* desc = task->description ? task->description : TASK_DEFAULT_DESCRIPTION;
+        TaskBinRecord* record = &records[i];
+        record->id = task->id;
+        record->title_length = strnlen(title, TASK_TITLE_MAX_LENGTH);
+        record->title_offset = taskbin_heap_add(heap, &heap_used, title,
+                                                record->title_length);
+        record->desc_length = strnlen(desc, TASK_DESCRIPTION_MAX_LENGTH);
+        record->desc_offset = taskbin_heap_add(heap, &heap_used, desc,
+                                               record->desc_length);
+        record->flags = task->is_complete ? TASKBIN_RECORD_COMPLETE : 0;
+        record->color = task->color;
+    }
+
+    *length = total_size;
+    return result;
+}
+
+TaskList* taskbin_to_task_list(char* data, size_t length)
+{
+    // check the header
+    if (!taskbin_is_binary(data, length) || length < sizeof(TaskBinHeader))
+    { return NULL; }
+    TaskBinHeader* header = (TaskBinHeader*) data;
+    if (header->byte_order != TASKBIN_BYTE_ORDER ||
+        header->version != TASKBIN_VERSION ||
+        header->header_size != sizeof(TaskBinHeader) ||
+        header->record_size != sizeof(TaskBinRecord))
+    { return NULL; }
+
+    // make sure the records and the heap fit inside the data
+    size_t records_size = (size_t) header->task_count * sizeof(TaskBinRecord);
+    if (records_size / sizeof(TaskBinRecord) != header->task_count ||
+        sizeof(TaskBinHeader) + records_size + header->heap_size != length)
+    { return NULL; }
+    TaskBinRecord* records = (TaskBinRecord*) (data + sizeof(TaskBinHeader));
+    char* heap = data + sizeof(TaskBinHeader) + records_size;
+
+    // create the list itself
+    if (!taskbin_string_is_valid(heap, header->heap_size, header->name_offset,
+                                 header->name_length))
+    { return NULL; }
+    TaskList* list = task_list_new(heap + header->name_offset);
+    if (!list) { return NULL; }
+    list->arena = arena_new(header->task_count * sizeof(Task));
+    if (!list->arena)
+    {
+        task_list_free(list);
+        return NULL;
+    }
+    list->format = TASK_LIST_FORMAT_BINARY;
+    if (header->color < color_count()) { list->color = header->color; }
+
+    // create a task for each record. The strings aren't copied: each task
+    // points straight at its strings in the heap. A record whose strings
+    // don't fit in the heap means the file is corrupt, so (just like a bad
+    // header) the whole list is rejected, rather than dropping the task and
+    // losing it for good the next time the list is saved
+    for (uint32_t i = 0; i < header->task_count; i++)
+    {
+        TaskBinRecord* record = &records[i];
+        if (!taskbin_string_is_valid(heap, header->heap_size,
+                                     record->title_offset, record->title_length) ||
+            !taskbin_string_is_valid(heap, header->heap_size,
+                                     record->desc_offset, record->desc_length))
+        {
+            task_list_free(list);
+            return NULL;
+        }
+        Task* task = task_new_borrowed(heap + record->title_offset,
+                                       heap + record->desc_offset, list->arena);
+        if (!task)
+        {
+            task_list_free(list);
+            return NULL;
+        }
+        task->id = record->id;
+        task->is_complete = (record->flags & TASKBIN_RECORD_COMPLETE) != 0;
+        if (record->color < color_count()) { task->color = record->color; }
+        task_list_append(list, task);
+    }
+
+    return list;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Returns 1 if the string at the given offset and length lies entirely within
+// the heap and is null-terminated, and 0 otherwise.
+int taskbin_string_is_valid(char* heap, uint32_t heap_size, uint32_t offset,
+                            uint32_t length)
+{
+    return (uint64_t) offset + length < heap_size &&
+           heap[offset + length] == '\0';
+}
+
+// Copies a string (and a null terminator) into the next free spot in the heap,
+// and returns the offset it was copied to.
+uint32_t taskbin_heap_add(char* heap, uint32_t* heap_used, char* string,
+                          uint32_t length)
+{
+    uint32_t offset = *heap_used;
+    memcpy(heap + offset, string, length);
+    heap[offset + length] = '\0';
+    *heap_used += length + 1;
+    return offset;
+}
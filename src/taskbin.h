@@ -0,0 +1,79 @@
+// This header file defines ttydo's binary task list format: an alternative to
+// the comma-separated text format that can be memory-mapped and used without
+// parsing. A binary file is laid out as:
+//
+//      [TaskBinHeader] [TaskBinRecord x task_count] [string heap]
+//
+// Each record refers to its title and description by offset into the string
+// heap, where every string is stored with a null terminator. This lets the
+// tasks of a loaded list point straight into the mapped file.
+//
+//      Connor Shugg
+
+#ifndef TASKBIN_H
+#define TASKBIN_H
+
+// Module inclusions
+#include <stddef.h>
+#include <inttypes.h>
+#include "tasklist.h"
+
+// ========================= Constants and Macros ========================== //
+#define TASKBIN_MAGIC "ttydobin"        // first 8 bytes of every binary file
+#define TASKBIN_MAGIC_LENGTH 8
+#define TASKBIN_VERSION 1
+#define TASKBIN_BYTE_ORDER 0x01020304   // detects files from other machines
+#define TASKBIN_NO_COLOR 0xff           // color index for an unknown color
+
+// record flags
+#define TASKBIN_RECORD_COMPLETE 0x1     // the task is complete
+
+
+// ============================ On-Disk Structs ============================ //
+// The 'TaskBinHeader' sits at the very beginning of a binary task list file.
+typedef struct _TaskBinHeader
+{
+    char magic[TASKBIN_MAGIC_LENGTH];   // TASKBIN_MAGIC (not null-terminated)
+    uint32_t byte_order;                // TASKBIN_BYTE_ORDER
+    uint32_t version;                   // TASKBIN_VERSION
+    uint32_t header_size;               // sizeof(TaskBinHeader)
+    uint32_t record_size;               // sizeof(TaskBinRecord)
+    uint32_t task_count;                // number of records
+    uint32_t name_offset;               // list name's offset into the heap
+    uint32_t name_length;               // list name's length
+    uint32_t heap_size;                 // size of the string heap, in bytes
+    uint8_t color;                      // list color index
+    uint8_t reserved[7];
+} TaskBinHeader;
+
+// The 'TaskBinRecord' holds a single task.
+typedef struct _TaskBinRecord
+{
+    uint64_t id;                        // the task's ID
+    uint32_t title_offset;              // title's offset into the heap
+    uint32_t title_length;              // title's length
+    uint32_t desc_offset;               // description's offset into the heap
+    uint32_t desc_length;               // description's length
+    uint8_t flags;                      // TASKBIN_RECORD_* bits
+    uint8_t color;                      // task color index
+    uint8_t reserved[6];
+} TaskBinRecord;
+
+
+// ========================== Conversion Functions ========================= //
+// Takes in a buffer (such as the beginning of a file) and its length, and
+// returns 1 if it holds a binary task list, or 0 if it doesn't.
+int taskbin_is_binary(char* data, size_t length);
+
+// Takes in a TaskList and builds the contents of a binary task list file for
+// it. The buffer's length is saved to 'length'. The returned buffer is
+// dynamically allocated. On failure, NULL is returned.
+char* taskbin_from_task_list(TaskList* list, size_t* length);
+
+// Takes in the contents of a binary task list file and its length, and builds
+// a new TaskList from it. The tasks' titles and descriptions point directly
+// into 'data', so it must outlive the list (see the TaskList's 'mapping'
+// field). On failure (or if the data is malformed), NULL is returned.
+TaskList* taskbin_to_task_list(char* data, size_t length);
+
+#endif
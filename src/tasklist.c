@@ -6,36 +6,22 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
 #include "tasklist.h"
 #include "visual/terminal.h"
 #include "visual/bar.h"
+#include "visual/width.h"
 #include "cli/utils.h"
 
 
-// =========================== List Elem Struct ============================ //
-TaskListElem* task_list_elem_new(Task* payload, TaskListElem* previous, TaskListElem* next)
-{
-    // attempt to allocate a new list elem
-    TaskListElem* elem = calloc(1, sizeof(TaskListElem));
-    if (!elem) { return NULL; }
-
-    // set the elem's fields and return
-    elem->task = payload;
-    elem->prev = previous;
-    elem->next = next;
-    return elem;
-}
-
-Task* task_list_elem_free(TaskListElem* elem)
-{
-    // if we were given a NULL pointer, return NULL
-    if (!elem) { return NULL; }
-
-    // pull out the payload, free the elem, and return the task
-    Task* payload = elem->task;
-    free(elem);
-    return payload;
-}
+// =============== Constants and Helper Function Prototypes ================ //
+#define TASK_LIST_INITIAL_CAPACITY 8    // first size of a list's task array
+int task_list_reserve(TaskList* list, int capacity);
+int task_list_build_indexes(TaskList* list);
+void task_list_drop_indexes(TaskList* list);
+void task_list_index_add(TaskList* list, Task* task);
+void task_list_index_remove(TaskList* list, Task* task);
+Task* task_list_first_match(TaskList* list, char* title, uint64_t id);
 
 
 // ============================== List Struct ============================== //
@@ -65,10 +51,10 @@ TaskList* task_list_new(char* list_name)
     // set the default color
     task_list_set_color(list, NULL);
 
-    // initialize the head, tail, and size to be NULL and 0
-    list->head = NULL;
-    list->tail = NULL;
+    // start with an empty task array (it's allocated by the first append)
+    list->tasks = NULL;
     list->size = 0;
+    list->capacity = 0;
     return list;
 }
 
@@ -77,23 +63,16 @@ void task_list_free(TaskList* list)
     // if we were given a NULL pointer, simply return
     if (!list) { return; }
 
-    // if the size is greater than zero, free each individual element
-    if (list->size > 0)
-    {
-        // start at the head node and iterate down, freeing elements
-        TaskListElem* current = list->head;
-        int i = 0;
-        while (i < list->size && current)
-        {
-            TaskListElem* next = current->next;             // grab next elem
-            Task* payload = task_list_elem_free(current);   // free current
-            task_free(payload);                             // free task
+    // free each task, then the array that held them
+    for (int i = 0; i < list->size; i++)
+    { task_free(list->tasks[i]); }
+    free(list->tasks);
+    task_list_drop_indexes(list);
 
-            // increment counter and pointer
-            i++;
-            current = next;
-        }
-    }
+    // unmap the list's file, if its tasks were borrowing from it, and release
+    // the arena its tasks were allocated from
+    if (list->mapping) { munmap(list->mapping, list->mapping_length); }
+    arena_free(list->arena);
 
     // free the name string and the list itself
     free(list->name);
@@ -106,27 +85,14 @@ int task_list_append(TaskList* list, Task* task)
     // non-zero value to indicate failure
     if (!list || !task) { return 1; }
 
-    // create a new list element to carry the Task. If allocation fails, return
-    // a non-zero
-    TaskListElem* elem = task_list_elem_new(task, list->tail, NULL);
-    if (!elem) { return 1; }
+    // make room for one more task (if the array grows, it doubles, so
+    // appending is amortized constant-time). If that fails, return a non-zero
+    if (task_list_reserve(list, list->size + 1)) { return 1; }
 
-    // if the list's size is currently zero, set both the head and tail to be
-    // pointing at the new list element
-    if (list->size == 0)
-    {
-        list->head = elem;
-        list->tail = elem;
-    }
-    // otherwise, update the current tail node, and the list's tail pointer
-    else
-    {
-        list->tail->next = elem;
-        list->tail = elem;
-    }
-    
-    // increment the list size and return
-    list->size++;
+    // place the task at the end of the array and increment the size
+    list->tasks[list->size++] = task;
+    list->completed_count += task->is_complete != 0;
+    task_list_index_add(list, task);
     return 0;
 }
 
@@ -138,30 +104,17 @@ int task_list_insert(TaskList* list, Task* task, int index)
     if (index < 0 || index > list->size)
     { return 1; }
 
-    // if the list is empty OR the index specified is the final index, just
-    // append the task and return
-    if (list->size == 0 || index == list->size)
-    { return task_list_append(list, task); }
-
-    // iterate and find the location of the new task
-    TaskListElem* insert_before = list->head;
-    int i = 0;
-    while (i++ < index && insert_before)
-    { insert_before = insert_before->next; }
-
-    // create a new list element to carry the task (make sure to specify that
-    // it will be placed before the node we just found)
-    TaskListElem* elem = task_list_elem_new(task, insert_before->prev,
-                                            insert_before);
-    // update the appropriate pointers
-    if (insert_before->prev) { insert_before->prev->next = elem; }
-    insert_before->prev = elem;
-
-    // if we just inserted at the head, update the list's head pointer
-    if (index == 0)
-    { list->head = elem; }
+    // make room for one more task
+    if (task_list_reserve(list, list->size + 1)) { return 1; }
 
+    // shift every task at or after the index up one slot, then place the new
+    // task in the gap
+    memmove(list->tasks + index + 1, list->tasks + index,
+            (list->size - index) * sizeof(Task*));
+    list->tasks[index] = task;
     list->size++;
+    list->completed_count += task->is_complete != 0;
+    task_list_index_add(list, task);
     return 0;
 }
 
@@ -172,84 +125,84 @@ Task* task_list_get_by_index(TaskList* list, int list_index)
     // if an invalid list index was given, return NULL
     if (list_index < 0 || list_index >= list->size)
     { return NULL; }
-    // if our list's size is 0, return NULL
-    if (list->size == 0) { return NULL; }
-
-    // iterate until we reach the correct list index
-    TaskListElem* current = list->head;
-    int i = 0;
-    while (i++ < list_index && current)
-    { current = current->next; }
 
-    // extract the Task payload and return it
-    return current->task;
+    return list->tasks[list_index];
 }
 
 Task* task_list_get_by_title(TaskList* list, char* task_title)
 {
     // if NULL pointers were given, return NULL
     if (!list || !task_title) { return NULL; }
-    // if our list's size is 0, return NULL
-    if (list->size == 0) { return NULL; }
-
-    // iterate through the list until a matching task is found
-    TaskListElem* match = NULL;
-    TaskListElem* current = list->head;
-    int i = 0;
-    while (i++ < list->size && current && !match)
+    if (task_list_build_indexes(list))
+    { return task_list_first_match(list, task_title, 0); }
+
+    // check every task stored under the title's hash
+    uint64_t hash = hash_index_string(task_title);
+    size_t position = 0;
+    Task* match = NULL;
+    Task* task;
+    while ((task = hash_index_next(list->title_index, hash, &position)))
     {
-        // if the current task's title matches, we've found the correct element
-        if (!strcmp(current->task->title, task_title))
-        { match = current; }
+        if (strcmp(task->title, task_title)) { continue; }
+        // if more than one task has this title, fall back to searching the
+        // list in order, so the first one is returned
+        if (match) { return task_list_first_match(list, task_title, 0); }
+        match = task;
+    }
+    return match;
+}
 
-        // increment pointer
-        current = current->next;
+Task* task_list_get_by_id(TaskList* list, uint64_t id)
+{
+    // if a NULL pointer was given, return NULL
+    if (!list) { return NULL; }
+    if (task_list_build_indexes(list))
+    { return task_list_first_match(list, NULL, id); }
+
+    // check every task stored under the ID's hash
+    uint64_t hash = hash_index_integer(id);
+    size_t position = 0;
+    Task* match = NULL;
+    Task* task;
+    while ((task = hash_index_next(list->id_index, hash, &position)))
+    {
+        if (task->id != id) { continue; }
+        if (match) { return task_list_first_match(list, NULL, id); }
+        match = task;
     }
+    return match;
+}
 
-    // if a match wasn't found, return NULL
-    if (!match) { return NULL; }
+int task_list_index_of(TaskList* list, Task* task)
+{
+    // if NULL pointers were given, return -1
+    if (!list || !task) { return -1; }
 
-    // extract the Task and return it
-    return match->task;
+    // iterate through the list until the matching task pointer is found
+    for (int i = 0; i < list->size; i++)
+    {
+        if (list->tasks[i] == task)
+        { return i; }
+    }
+    return -1;
 }
 
 Task* task_list_remove(TaskList* list, Task* task)
 {
-    // if we were given NULL pointers, return a non-zero to indicate failure
+    // if we were given NULL pointers, return NULL to indicate failure
     if (!list || !task) { return NULL; }
 
-    // iterate through each list element to find the correct TaskListElem
-    TaskListElem* match = NULL;
-    TaskListElem* current = list->head;
-    int i = 0;
-    while (i++ < list->size && current && !match)
-    {
-        // if the pointers match, we've found the correct element
-        if (current->task == task)
-        { match = current; }
-
-        // increment pointer
-        current = current->next;
-    }
+    // find the task's index. If it isn't in the list, return NULL
+    int index = task_list_index_of(list, task);
+    if (index < 0) { return NULL; }
 
-    // if a match wasn't found, return NULL
-    if (!match) { return NULL; }
-
-    // get references to adjacent nodes
-    TaskListElem* left = match->prev;
-    TaskListElem* right = match->next;
-    // update both pointers to point at each other, removing references to
-    // our node-of-interest
-    if (left) { left->next = right; }
-    if (right) { right->prev = left; }
-    // update list pointers (if needed)
-    if (list->head == match) { list->head = right; }
-    if (list->tail == match) { list->tail = left; }
-    
-    // decrement size, free the list elem and return the inner Task
+    // shift every task after it down one slot, closing the gap
+    memmove(list->tasks + index, list->tasks + index + 1,
+            (list->size - index - 1) * sizeof(Task*));
     list->size--;
-    Task* payload = task_list_elem_free(match);
-    return payload;
+    list->completed_count -= task->is_complete != 0;
+    task_list_index_remove(list, task);
+    return task;
 }
 
 BoxStack* task_list_to_box_stack(TaskList* list, int fill_width)
@@ -265,42 +218,17 @@ BoxStack* task_list_to_box_stack(TaskList* list, int fill_width)
         return NULL;
     }
 
-    // first, we'll count the amount of space we'll need for our inner box
-    // string - by summing up each task's to_string() result. We'll also use
-    // this loop to count the number of completed tasks.
-    int tasks_complete = 0;
-    char* task_strings[list->size + 1];
-    task_strings[list->size] = NULL; // null terminated
-    TaskListElem* current = list->head;
-    int i = 0;
-    int box_string_size = 0;
-    while (i < list->size && current)
-    {
-        tasks_complete += current->task->is_complete != 0;
-        // convert the current task to a string and add the string's length
-        task_strings[i] = task_to_string(current->task);
-        if (task_strings[i]) { box_string_size += strlen(task_strings[i++]); }
-        current = current->next;
-    }
-    // calculate the final size for our inner box string and allocate it
-    box_string_size += (8 * list->size);
-    char* box_string = calloc(box_string_size + 1, sizeof(char));
-    // if the allocation failed, return NULL
-    if (!box_string) { return NULL; }
-
-    // add each task string to the box string (and free the individual task
-    // strings along the way)
-    int box_string_length = 0;
+    // render every task into one string, one task per line
+    int tasks_complete = list->completed_count;
+    OutputBuffer* text = output_buffer_new();
+    if (!text) { return NULL; }
     for (int i = 0; i < list->size; i++)
     {
-        int task_string_length = strlen(task_strings[i]);
-        memmove(box_string + box_string_length, task_strings[i], task_string_length);
-        box_string_length += task_string_length;
-
-        if (i < list->size - 1)
-        { memmove(box_string + box_string_length++, "\n", 1);}
-        free(task_strings[i]);
+        if (i > 0) { output_string(text, "\n"); }
+        task_render(list->tasks[i], text);
     }
+    char* box_string = output_buffer_detach(text);
+    if (!box_string) { return NULL; }
 
     // create a box stack to hold the multiple boxes. If allocation failed,
     // free all memory and return NULL
@@ -324,7 +252,7 @@ BoxStack* task_list_to_box_stack(TaskList* list, int fill_width)
     int progbar_width = text_box->width - 4;
     if (fill_width) { progbar_width = get_terminal_width() - 4; }
     // create a new progress bar
-    char* color_name = (char*) color_to_name(list->color);
+    char* color_name = (char*) color_name_from_index(list->color);
     ProgressBar* bar = progress_bar_new(progbar_width, percent_complete, color_name);
 
     // modify the second box - this will hold a progress bar
@@ -345,19 +273,121 @@ BoxStack* task_list_to_box_stack(TaskList* list, int fill_width)
     return stack;
 }
 
+int task_list_render(TaskList* list, int fill_width, OutputBuffer* out)
+{
+    if (!list || !out) { return 1; }
+
+    // just like the box stack, if 'fill_width' is enabled the terminal has to
+    // be wide enough to hold a box
+    if (fill_width && get_terminal_width() < BOX_MIN_WIDTH)
+    {
+        fprintf(stderr, "Terminal size is too small.\n");
+        return 1;
+    }
+
+    // every task is rendered into this buffer (one at a time) to be measured
+    OutputBuffer* row = output_buffer_new();
+    if (!row) { return 1; }
+
+    // first pass: find the widest line of any task, which decides how wide
+    // the box needs to be. Only the widest is kept, so this pass doesn't need
+    // any more memory for a longer list. (If the box fills the terminal, its
+    // width is already known.)
+    int longest_width = 0;
+    for (int i = 0; !fill_width && i < list->size; i++)
+    {
+        output_buffer_clear(row);
+        task_render(list->tasks[i], row);
+        char* cursor = row->data;
+        BoxTextSpan line;
+        while (box_text_next_line(&cursor, &line))
+        {
+            int width = display_width(line.start, line.length);
+            if (width > longest_width) { longest_width = width; }
+        }
+    }
+    output_buffer_free(row);
+    int width = list->size > 0 ? longest_width + 4 : BOX_MIN_WIDTH;
+    if (fill_width) { width = get_terminal_width(); }
+
+    // second pass: draw every task
+    return task_list_render_range(list, width, 0, list->size, out);
+}
+
+int task_list_render_range(TaskList* list, int width, int first, int last,
+                           OutputBuffer* out)
+{
+    if (!list || !out) { return 1; }
+    if (width < BOX_MIN_WIDTH) { width = BOX_MIN_WIDTH; }
+    if (first < 0) { first = 0; }
+    if (last > list->size) { last = list->size; }
+
+    // every task is rendered into this buffer (one at a time) before it's
+    // written out as a row
+    OutputBuffer* row = output_buffer_new();
+    if (!row) { return 1; }
+
+    // render each task and write its row(s) out right away, draining the
+    // output buffer as we go
+    box_render_top_line(out, width, BOX_TL_CORNER, BOX_TR_CORNER, list->name);
+    for (int i = first; i < last; i++)
+    {
+        output_buffer_clear(row);
+        task_render(list->tasks[i], row);
+        char* cursor = row->data;
+        BoxTextSpan line;
+        while (box_text_next_line(&cursor, &line))
+        { box_render_text_line(out, width, line.start, line.length); }
+        output_buffer_drain(out);
+    }
+
+    // finally, the progress bar (for the whole list) gets a box of its own,
+    // joined to the one above it
+    float percent_complete = (float) list->completed_count / (float) list->size;
+    if (list->completed_count == 0) { percent_complete = 0.0; }
+    char* color_name = (char*) color_name_from_index(list->color);
+    ProgressBar* bar = progress_bar_new(width - 4, percent_complete, color_name);
+    output_buffer_clear(row);
+    progress_bar_render(bar, row);
+    progress_bar_free(bar);
+    box_render_top_line(out, width, BOX_L_CROSS, BOX_R_CROSS, "Progress");
+    box_render_text_line(out, width, row->data, row->length);
+    box_render_bottom_line(out, width);
+
+    int failed = row->failed || out->failed;
+    output_buffer_free(row);
+    return failed;
+}
+
+void task_list_set_task_complete(TaskList* list, Task* task, int is_complete)
+{
+    if (!list || !task) { return; }
+    is_complete = is_complete != 0;
+    list->completed_count += is_complete - (task->is_complete != 0);
+    task->is_complete = is_complete;
+}
+
+void task_list_set_task_title(TaskList* list, Task* task, char* title)
+{
+    if (!list || !task) { return; }
+
+    // move the task to its new title's spot in the index
+    if (list->title_index)
+    { hash_index_remove(list->title_index, hash_index_string(task->title), task); }
+    task_set_title(task, title);
+    if (list->title_index &&
+        hash_index_add(list->title_index, hash_index_string(task->title), task))
+    { task_list_drop_indexes(list); }
+}
+
 void task_list_set_color(TaskList* list, char* name)
 {
     if (!list)
     { return; }
 
-    // search for the color
-    const char* cstr = color_from_name(name);
-
-    // copy the color in, if one was found
-    if (cstr)
-    { snprintf(list->color, COLOR_MAX_LENGTH, "%s", cstr); }
-    else
-    { snprintf(list->color, COLOR_MAX_LENGTH, "%s", C_BAR); }
+    // search for the color (or use the default)
+    int index = color_index_from_name(name);
+    list->color = index >= 0 ? index : COLOR_INDEX_BAR;
 }
 
 
@@ -373,7 +403,8 @@ char* task_list_get_scribe_string(TaskList* list)
     { name_length = TASK_LIST_NAME_MAX_LENGTH; }
     int size_length = 8;
     int color_length = COLOR_NAME_MAX_LENGTH + 1;
-    int length = name_length + size_length + color_length;
+    int completed_length = 8;
+    int length = name_length + size_length + color_length + completed_length;
 
     // allocate the string accordingly
     char* result = calloc(length + 1, sizeof(char));
@@ -383,13 +414,79 @@ char* task_list_get_scribe_string(TaskList* list)
     int size_wcount = snprintf(result + name_length, size_length, ",%d", list->size);
     
     // convert the list's color to a name string and copy it in
-    const char* color_name = color_to_name(list->color);
-    snprintf(result + name_length + size_wcount, color_length, ",%s", color_name);
+    const char* color_name = color_name_from_index(list->color);
+    int color_wcount = snprintf(result + name_length + size_wcount,
+                                color_length, ",%s", color_name);
+
+    // finally, add the completed count
+    snprintf(result + name_length + size_wcount + color_wcount,
+             completed_length, ",%d", list->completed_count);
+
+    return result;
+}
+
+int task_list_write_scribe_header(TaskList* list, char* buffer, int capacity)
+{
+    // check for a NULL pointer or a NULL 'name' pointer
+    if (!list || !list->name) { return -1; }
+
+    // convert the list's color to a name string
+    const char* color_name = color_name_from_index(list->color);
+    if (!color_name) { color_name = ""; }
+
+    // the name goes last, so it may contain any character
+    int name_length = strnlen(list->name, TASK_LIST_NAME_MAX_LENGTH);
+    return snprintf(buffer, capacity, "#%d,%d,%d,%s,%d:%.*s\n",
+                    TASK_LIST_SCRIBE_VERSION, name_length, list->size,
+                    color_name, list->completed_count, name_length, list->name);
+}
 
+TaskList* task_list_new_from_scribe_header(char* buffer, int length, int* consumed,
+                                           int* size, int* completed)
+{
+    if (!buffer || length <= 0) { return NULL; }
+    char* end = buffer + length;
+
+    // find the end of the fixed fields, and make a terminated copy of them
+    char* colon = memchr(buffer, ':', length);
+    if (!colon || colon - buffer > COLOR_NAME_MAX_LENGTH + 64) { return NULL; }
+    int fields_length = colon - buffer;
+    char fields[fields_length + 1];
+    memcpy(fields, buffer, fields_length);
+    fields[fields_length] = '\0';
+
+    // parse the version, name length, size, color, and completed count. Any
+    // fields after those (added by later versions) are ignored
+    int version = 0;
+    int name_length = 0;
+    int header_size = -1;
+    int header_completed = -1;
+    char color_name[COLOR_NAME_MAX_LENGTH] = {'\0'};
+    int matched = sscanf(fields, "#%d,%d,%d,%63[^,],%d", &version, &name_length,
+                         &header_size, color_name, &header_completed);
+    // (an empty color name stops the match early, so look past it)
+    if (matched == 3)
+    { sscanf(fields, "#%*d,%*d,%*d,,%d", &header_completed); }
+    if (matched < 3 || version != TASK_LIST_SCRIBE_VERSION ||
+        name_length <= 0 || name_length >= end - (colon + 1) ||
+        colon[1 + name_length] != '\n')
+    { return NULL; }
+
+    // copy the name out and create the list
+    char name[name_length + 1];
+    memcpy(name, colon + 1, name_length);
+    name[name_length] = '\0';
+    TaskList* result = task_list_new(name);
+    if (!result) { return NULL; }
+    task_list_set_color(result, color_name[0] ? color_name : NULL);
+
+    *consumed = (colon + 1 + name_length + 1) - buffer;
+    if (size) { *size = header_size; }
+    if (completed) { *completed = header_completed; }
     return result;
 }
 
-TaskList* task_list_new_from_scribe_string(char* string)
+TaskList* task_list_new_from_scribe_string(char* string, int* size, int* completed)
 {
     // check for a NULL pointer
     if (!string) { return NULL; }
@@ -400,22 +497,112 @@ TaskList* task_list_new_from_scribe_string(char* string)
     snprintf(local, len + 1, "%s", string);
     
     // look for the first comma. Everything before this is the task list name
-    char* name = strtok(local, ",");
+    char* save = NULL;
+    char* name = strtok_r(local, ",", &save);
     if (!name) { return NULL; }
 
     // skip over the second string (the size)
-    char* size_str = strtok(NULL, ",");
+    char* size_str = strtok_r(NULL, ",", &save);
     if (!size_str) { return NULL; }
 
-    // the third string holds the list's color
-    char* color_name = strtok(NULL, ",");
-    char* cname = strtok(color_name, "\n");
+    // the third string holds the list's color, and the fourth (if it's
+    // there) holds the completed count
+    char* color_name = strtok_r(NULL, ",", &save);
+    char* completed_str = strtok_r(NULL, ",", &save);
+    char* cname = color_name ? strtok_r(color_name, "\n", &save) : NULL;
     
     // create a new TaskList with the name
     TaskList* result = task_list_new(name);
-    task_list_set_color(result, cname);
     if (!result) { return NULL; }
+    task_list_set_color(result, cname);
+
+    // save the counts, if they were asked for
+    if (size) { *size = atoi(size_str); }
+    if (completed) { *completed = completed_str ? atoi(completed_str) : -1; }
 
     // return the task list
     return result;
 }
+
+
+// =========================== Helper Functions ============================ //
+// Makes sure the list's task array can hold at least 'capacity' tasks,
+// doubling its size as many times as needed. Returns 0 on success and non-zero
+// if the array couldn't be grown.
+int task_list_reserve(TaskList* list, int capacity)
+{
+    if (capacity <= list->capacity) { return 0; }
+
+    // double the current capacity until it's big enough
+    int new_capacity = list->capacity > 0 ? list->capacity : TASK_LIST_INITIAL_CAPACITY;
+    while (new_capacity < capacity) { new_capacity *= 2; }
+
+    Task** tasks = realloc(list->tasks, new_capacity * sizeof(Task*));
+    if (!tasks) { return 1; }
+    list->tasks = tasks;
+    list->capacity = new_capacity;
+    return 0;
+}
+
+// Builds the list's title and ID indexes, if they haven't been built yet.
+// Returns 0 on success and non-zero if they couldn't be built (in which case
+// the list has to be searched in order).
+int task_list_build_indexes(TaskList* list)
+{
+    if (list->title_index && list->id_index) { return 0; }
+    task_list_drop_indexes(list);
+    list->title_index = hash_index_new();
+    list->id_index = hash_index_new();
+    if (!list->title_index || !list->id_index)
+    {
+        task_list_drop_indexes(list);
+        return 1;
+    }
+
+    for (int i = 0; i < list->size; i++)
+    {
+        task_list_index_add(list, list->tasks[i]);
+        if (!list->title_index) { return 1; }
+    }
+    return 0;
+}
+
+// Frees the list's indexes. They'll be rebuilt by the next search.
+void task_list_drop_indexes(TaskList* list)
+{
+    hash_index_free(list->title_index);
+    hash_index_free(list->id_index);
+    list->title_index = NULL;
+    list->id_index = NULL;
+}
+
+// Adds a task to the list's indexes (if they've been built). If the indexes
+// can't hold it, they're dropped rather than left incomplete.
+void task_list_index_add(TaskList* list, Task* task)
+{
+    if (!list->title_index) { return; }
+    if (hash_index_add(list->title_index, hash_index_string(task->title), task) ||
+        hash_index_add(list->id_index, hash_index_integer(task->id), task))
+    { task_list_drop_indexes(list); }
+}
+
+// Removes a task from the list's indexes (if they've been built).
+void task_list_index_remove(TaskList* list, Task* task)
+{
+    if (!list->title_index) { return; }
+    hash_index_remove(list->title_index, hash_index_string(task->title), task);
+    hash_index_remove(list->id_index, hash_index_integer(task->id), task);
+}
+
+// Searches the list in order for the first task with the given title (or, if
+// the title is NULL, the given ID).
+Task* task_list_first_match(TaskList* list, char* title, uint64_t id)
+{
+    for (int i = 0; i < list->size; i++)
+    {
+        Task* task = list->tasks[i];
+        if (title ? !strcmp(task->title, title) : task->id == id)
+        { return task; }
+    }
+    return NULL;
+}
@@ -1,5 +1,6 @@
 // A module that defines struct(s) and functions that represent a list of
-// tasks. The TaskList is a doubly-linked, dynamically-allocated list.
+// tasks. The TaskList keeps its tasks in a growable, dynamically-allocated
+// array, so any task can be reached by its index in constant time.
 //
 //      Connor Shugg
 
@@ -7,32 +8,20 @@
 #define TASKLIST_H
 
 // Module inclusions
+#include <stddef.h>
 #include "task.h"
+#include "hashindex.h"
+#include "arena.h"
 #include "visual/boxstack.h"
 #include "visual/colors.h"
 
 // ========================== Constants & Macros =========================== //
 #define TASK_LIST_NAME_MAX_LENGTH 64    // maximum character count for a name
+#define TASK_LIST_SCRIBE_VERSION 2      // version of the text file format
 
-// =========================== List Elem Struct ============================ //
-// The 'TaskListElemn' struct represents a single node of a TaskList.
-typedef struct _TaskListElem
-{
-    Task* task;
-    struct _TaskListElem* prev;
-    struct _TaskListElem* next;
-} TaskListElem;
-
-// Takes in a Task pointer and two TaskListElem pointers and uses them to make
-// a new dynamically-allocated TaskListElem. The pointer is returned. If
-// allocation fails, NULL is returned.
-TaskListElem* task_list_elem_new(Task* payload, TaskListElem* previous, TaskListElem* next);
-
-// Takes in a TaskListElem pointer and attempts to free its memory. Any other
-// TaskListElems pointed at the by this elem's 'prev' and 'next' fields are
-// ignored. The inner Task* payload is not freed - instead, it's returned.
-Task* task_list_elem_free(TaskListElem* elem);
-
+// formats a task list can be saved to disk in
+#define TASK_LIST_FORMAT_TEXT 0         // comma-separated text (the default)
+#define TASK_LIST_FORMAT_BINARY 1       // memory-mappable binary (taskbin.h)
 
 // ============================== List Struct ============================== //
 // The 'TaskList' struct represents a list of Tasks.
@@ -40,22 +29,38 @@ typedef struct _TaskLisk
 {
     char* name;                     // name of the task list
     int size;                       // number of tasks in the list
-    TaskListElem* head;             // head node of the linked list
-    TaskListElem* tail;             // the tail node of the linked list
-    char color[COLOR_MAX_LENGTH];   // color string
+    int completed_count;            // number of those that are complete
+    Task** tasks;                   // array of the list's tasks, in order
+    int capacity;                   // number of slots in the 'tasks' array
+    HashIndex* title_index;         // tasks by title hash (built on demand)
+    HashIndex* id_index;            // tasks by ID hash (built on demand)
+    uint8_t color;                  // color (palette index, see colors.h)
+    int format;                     // on-disk format (TASK_LIST_FORMAT_*)
+    void* mapping;                  // mapped file the tasks' strings may
+    size_t mapping_length;          // point into (unmapped with the list)
+    Arena* arena;                   // arena the tasks may be allocated from
+    int dirty;                      // changed, but not saved (see scribe.h)
 } TaskList;
 
 // Constructor: dynamically allocates a new TaskList pointer. If allocation
 // fails, NULL is returned.
 TaskList* task_list_new(char* list_name);
 
-// Destructor: frees a task list an all of its inner TaskListElems (including
-// each TaskListElem's inner Task pointer).
+// Destructor: frees a task list and all of its inner Task pointers. If the
+// list was loaded from a memory-mapped file, the file is unmapped, and if its
+// tasks were allocated from its arena, the arena is released (all at once).
+// Either way, any tasks removed from the list must be freed first.
 void task_list_free(TaskList* list);
 
+// NOTE: the list keeps a count of its completed tasks ('completed_count'),
+// which every function below keeps up to date. A task's 'is_complete' flag
+// must only be changed through 'task_list_set_task_complete' while the task
+// is in a list.
+//
 // Takes a dynamically-allocated Task pointer and attempts to add it to the end
-// of the list. On success, 0 is returned. A non-zero value is returned
-// otherwise.
+// of the list. The task array doubles in size when it fills up, so appending
+// is amortized constant-time. On success, 0 is returned. A non-zero value is
+// returned otherwise.
 int task_list_append(TaskList* list, Task* task);
 
 // Takes a dynamically-allocated Task pointer and attempts to insert it into
@@ -64,21 +69,42 @@ int task_list_append(TaskList* list, Task* task);
 // up/down accordingly.
 int task_list_insert(TaskList* list, Task* task, int index);
 
-// Uses the given index to get the Task stored at the corresponding node (as if
-// the linked list was an array). The Task* is returned on success, and NULL
-// is returned on failure.
+// Uses the given index to get the Task stored at the corresponding slot of the
+// list's array. The Task* is returned on success, and NULL is returned on
+// failure.
 Task* task_list_get_by_index(TaskList* list, int list_index);
 
 // Searches the task list for a task with the given name. If a task is found,
 // the pointer to the Task struct is returned. Otherwise, NULL is returned.
+// (If more than one task has the name, the first one in the list is returned.)
+// The first search by title or ID builds the list's hash indexes, which are
+// kept up to date from then on, so searches take constant time.
 Task* task_list_get_by_title(TaskList* list, char* task_title);
 
-// Takes in a pointer to a Task struct and searches the list for the
-// TaskListElem that contains the pointer. If it's found, the item is removed
+// Searches the task list for a task with the given ID. If one is found, the
+// pointer to the Task struct is returned. Otherwise, NULL is returned.
+// (Like titles, duplicate IDs resolve to the first task in the list.)
+Task* task_list_get_by_id(TaskList* list, uint64_t id);
+
+// Searches the task list for the given Task pointer and returns its index
+// within the list. If the task isn't in the list, -1 is returned.
+int task_list_index_of(TaskList* list, Task* task);
+
+// Takes in a pointer to a Task struct and searches the list for it. If it's
+// found, the item is removed (and the tasks after it are shifted down)
 // and the Task pointer is returned. It's up to the caller to free the Task
 // pointer's memory. (If the task isn't found and removed, NULL is returned.)
 Task* task_list_remove(TaskList* list, Task* task);
 
+// Marks a task within the list as complete (if 'is_complete' is non-zero) or
+// incomplete, and updates the list's completed count.
+void task_list_set_task_complete(TaskList* list, Task* task, int is_complete);
+
+// Changes the title of a task within the list. Titles of tasks in a list must
+// be changed through this function (rather than 'task_set_title'), so the
+// list's title index stays correct.
+void task_list_set_task_title(TaskList* list, Task* task, char* title);
+
 // Takes in a pointer to a TaskList and attempts to create a custom BoxStack
 // for the list.The 'fill_width' parameter is used to indicate if the printed
 // box should take up the entire width of the terminal. If it's non-zero, the
@@ -86,19 +112,61 @@ Task* task_list_remove(TaskList* list, Task* task);
 // still fitting each task string inside.
 BoxStack* task_list_to_box_stack(TaskList* list, int fill_width);
 
+// Renders the list into the given output buffer, looking exactly like its box
+// stack ('task_list_to_box_stack'), but without ever building the stack: each
+// task is rendered and written out as its own row, so drawing a huge list
+// only needs memory for one task at a time. (If the buffer is being streamed,
+// see output.h, it's drained as the rows are written.) Returns 0 on success
+// and a non-zero value on failure.
+int task_list_render(TaskList* list, int fill_width, OutputBuffer* out);
+
+// Works like 'task_list_render', but draws the list in a box that's 'width'
+// characters wide, holding only the tasks from index 'first' up to (but not
+// including) 'last'. The progress bar still covers the whole list. Nothing
+// outside the range is looked at, so the cost depends only on its size.
+int task_list_render_range(TaskList* list, int width, int first, int last,
+                           OutputBuffer* out);
+
 // Accepts a color name and attempts to update the task list's color.
 void task_list_set_color(TaskList* list, char* name);
 
 
 // ========================== File String Parsing ========================== //
-// Takes in a pointer to a task list and generates a header string used by the
-// scribe (scribe.c/scribe.h) to write a TaskList out to a file.
+// A text task list file begins with a header line. In version 2 of the
+// format, it holds the list's name last (with its length up front), so names
+// may contain any character:
+//
+//      #2,<name length>,<size>,<color name>,<completed count>:<name>
+//
+// (The completed count was added after the rest of version 2, so it may be
+// missing. Readers ignore any fields after the color name that they don't
+// know about.)
+//
+// Takes in a task list and writes its header (followed by a newline) into the
+// given buffer, like 'snprintf'. The header's length is returned, or -1 on
+// failure.
+int task_list_write_scribe_header(TaskList* list, char* buffer, int capacity);
+
+// Takes in a buffer (and its length) that begins with a version 2 header, and
+// creates a new (empty) TaskList from it. The number of bytes the header took
+// up (including its newline) is saved to 'consumed'. The task and completed
+// counts the header records are saved to 'size' and 'completed' (either of
+// which may be NULL), or -1 if the header doesn't have them. This lets a
+// list's summary be read without reading its tasks. Returns NULL on failure.
+TaskList* task_list_new_from_scribe_header(char* buffer, int length, int* consumed,
+                                           int* size, int* completed);
+
+// Version 1 headers looked like "<name>,<size>,<color name>", and may also
+// have a completed count: "<name>,<size>,<color name>,<completed count>".
+//
+// Takes in a pointer to a task list and generates a version 1 header string.
 // Returns NULL on failure.
 char* task_list_get_scribe_string(TaskList* list);
 
 // Takes in a header string (generated by 'task_list_get_scribe_string') and
-// attempts to create a new TaskList struct with its information.
-// Returns NULL on failure.
-TaskList* task_list_new_from_scribe_string(char* string);
+// attempts to create a new TaskList struct with its information. The counts
+// it records are saved to 'size' and 'completed' (either of which may be
+// NULL), or -1 if it doesn't have them. Returns NULL on failure.
+TaskList* task_list_new_from_scribe_string(char* string, int* size, int* completed);
 
 #endif
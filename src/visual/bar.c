@@ -48,62 +48,37 @@ char* progress_bar_to_string(ProgressBar* bar)
     // if we're given a NULL pointer, return NULL
     if (!bar) { return NULL; }
 
-    // allocate a new string of the appropriate length
-    char* result = calloc((bar->width * PROGBAR_CHARACTER_SIZE) +
-                          (strlen(C_BAR_FRAME) * 2) +
-                          strlen(bar->color) +
-                          strlen(C_NONE),
-                          sizeof(char));
-    if (!result) { return NULL; }
+    // render the bar into a buffer, and take the string back out of it
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return NULL; }
+    progress_bar_render(bar, out);
+    return output_buffer_detach(out);
+}
+
+void progress_bar_render(ProgressBar* bar, OutputBuffer* out)
+{
+    if (!bar || !out) { return; }
 
     // --------------- Percentage String --------------- //
     int percent_string_length = 4;
-    char percent_string[percent_string_length + 1];
-    percent_string[percent_string_length] = '\0';
-    snprintf(percent_string, percent_string_length + 1, "%-3d%%", (int) (bar->percentage * 100));
-    // copy the local string to the result string
-    snprintf(result, percent_string_length + 1, "%s", percent_string);
+    output_printf(out, "%-3d%%", (int) (bar->percentage * 100));
 
     // -------------- Progress Bar String -------------- //
-    // allocate the local string
-    int bar_string_length = (bar->width - percent_string_length) * PROGBAR_CHARACTER_SIZE + 1 +
-                            (strlen(C_BAR_FRAME) * 2) + strlen(bar->color) + strlen(C_NONE);
-    char bar_string[bar_string_length + 1];
-    bar_string[bar_string_length] = '\0';
-    // copy the left border
-    int length = snprintf(bar_string, 2 + PROGBAR_CHARACTER_SIZE +
-                          strlen(C_BAR_FRAME) + strlen(bar->color),
-                          C_BAR_FRAME " %s%s", PROGBAR_L_BORDER, bar->color);
+    // write the left border
+    output_string(out, C_BAR_FRAME " " PROGBAR_L_BORDER);
+    output_string(out, bar->color);
     // calculate the number of 'filled' slots vs the number of 'empty' slots
     int total_slots = bar->width - percent_string_length - 3;
     int filled_count = (int) ((float) total_slots * bar->percentage);
-    // iterate and append bar characters
-    for (int i = 0; i < total_slots; i++)
+    if (filled_count > total_slots) { filled_count = total_slots; }
+    // write the filled slots, then switch to the bar frame's color for the
+    // empty ones (if there are any)
+    output_repeat(out, PROGBAR_FILLED, filled_count);
+    if (filled_count < total_slots)
     {
-        if (i < filled_count)
-        {
-            memmove(bar_string + length, PROGBAR_FILLED, PROGBAR_CHARACTER_SIZE);
-            length += PROGBAR_CHARACTER_SIZE;
-        }
-        else
-        {
-            // switch to the bar frame's color when necessary
-            if (i == filled_count)
-            {
-                memmove(bar_string + length, C_BAR_FRAME, strlen(C_BAR_FRAME));
-                length += strlen(C_BAR_FRAME);
-            }
-
-            memmove(bar_string + length, PROGBAR_EMPTY, PROGBAR_CHARACTER_SIZE);
-            length += PROGBAR_CHARACTER_SIZE;
-        }
+        output_string(out, C_BAR_FRAME);
+        output_repeat(out, PROGBAR_EMPTY, total_slots - filled_count);
     }
-    // copy the right border
-    memmove(bar_string + length, PROGBAR_R_BORDER, PROGBAR_CHARACTER_SIZE);
-    length += PROGBAR_CHARACTER_SIZE;
-    memmove(bar_string + length, C_NONE, strlen(C_NONE));
-
-    // copy the bar string onto the end string, and return it
-    memmove(result + strlen(result), bar_string, length);
-    return result;
+    // write the right border
+    output_string(out, PROGBAR_R_BORDER);
 }
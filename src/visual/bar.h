@@ -7,6 +7,7 @@
 #define BAR_H
 
 #include "colors.h"
+#include "output.h"
 
 // ========================= Constants and Macros ========================== //
 // Progress bar drawing definitions
@@ -46,4 +47,8 @@ void progress_bar_free(ProgressBar* bar);
 // pointer to it is returned. On failure, NULL is returned.
 char* progress_bar_to_string(ProgressBar* bar);
 
+// Works like 'progress_bar_to_string', but renders the progress bar into the
+// given output buffer.
+void progress_bar_render(ProgressBar* bar, OutputBuffer* out);
+
 #endif
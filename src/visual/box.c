@@ -4,22 +4,21 @@
 
 // Module inclusions
 #include <string.h>
+#include <unistd.h>
 #include "box.h"
 #include "colors.h"
+#include "width.h"
 
 
 // ====================== Helper Function Prototypes ======================= //
-char** make_box_lines(uint16_t width, uint16_t height, char* title, char* text);
-void free_string_array_null_terminated(char** lines);
-char** free_string_array(char** lines, int length);
-void fill_box_line(char** line, int width, char* left_edge,
-                   char* middle, char* right_edge);
-int fill_box_line_with_title(char** line, int width, char* left_edge,
-                             char* middle, char* right_edge, char* title);
-int fill_box_line_with_text(char** line, int width, char* left_edge,
-                            char* middle, char* right_edge, char* text);
-char** split_text_by_newline(char* text);
-int count_string_extended_unicode(char* text, int text_length);
+void render_box_line(OutputBuffer* out, int width, char* left_edge,
+                     char* middle, char* right_edge);
+void render_box_line_with_title(OutputBuffer* out, int width, char* left_edge,
+                                char* middle, char* right_edge, char* title);
+void render_box_line_with_text(OutputBuffer* out, int width, char* left_edge,
+                               char* middle, char* right_edge, BoxTextSpan* text);
+int render_fitted_text(OutputBuffer* out, char* text, int length,
+                       int max_columns);
 
 
 // ============================== Box Struct =============================== //
@@ -70,24 +69,19 @@ void box_adjust_to_text(Box* box, int force_readjust)
     if (!box->text || strlen(box->text) == 0)
     { return; }
 
-    char** lines = split_text_by_newline(box->text);
-    if (!lines) { return; }
-
     // count the number of lines in the text and find the longest line's
     // length in the lines
     int line_count = 0;
     int longest_width = -1;
-    char** current = lines;
-    while (*current)
+    char* cursor = box->text;
+    BoxTextSpan line;
+    while (box_text_next_line(&cursor, &line))
     {
         // update the longest length and increment the line counter
-        int length = strlen(*current);
-        if (length > longest_width) { longest_width = length; }
+        int width = display_width(line.start, line.length);
+        if (width > longest_width) { longest_width = width; }
         line_count++;
-
-        current++;
     }
-    if (lines) { free_string_array_null_terminated(lines); }
 
     // if the current box size is too small, adjust
     int width_diff = box->width - 4 - longest_width;
@@ -106,23 +100,53 @@ int box_print(Box* box)
     // check for a NULL pointer
     if (!box) { return 1; }
 
-    // invoke a helper function to generate an array of lines to print
-    char** lines = make_box_lines(box->width, box->height, box->title, box->text);
-    if (!lines)
+    // render the box into a buffer, then write it all out at once
+    OutputBuffer* out = output_buffer_new();
+    if (!out || box_render(box, out))
     {
+        output_buffer_free(out);
         fprintf(stdout, "Error: could not print %dx%d box!\n",
                 box->width, box->height);
         return 1;
     }
+    int result = output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
+    return result;
+}
 
-    // print each line to STDOUT (iterate until NULL is reached)
-    for (int i = 0; i < box->height; i++)
-    { fprintf(stdout, "%s\n", lines[i]); }
+int box_render(Box* box, OutputBuffer* out)
+{
+    return box_render_with_edges(box, out, BOX_TL_CORNER, BOX_TR_CORNER, 1);
+}
 
-    // free the allocated memory
-    free_string_array_null_terminated(lines);
+int box_render_with_edges(Box* box, OutputBuffer* out, char* top_left,
+                          char* top_right, int draw_bottom)
+{
+    // check for a NULL pointer, or a box that's too small to draw
+    if (!box || !out) { return 1; }
+    if (box->width < BOX_MIN_WIDTH || box->height < BOX_MIN_HEIGHT)
+    { return 1; }
+
+    // --------- Rendering first line --------- //
+    // if the box has a title, it goes in the top line
+    box_render_top_line(out, box->width, top_left, top_right, box->title);
+
+    // -------- Rendering middle lines -------- //
+    // walk through the box's text, one line at a time. Once it runs out, the
+    // rest of the box is left empty
+    char* cursor = box->text;
+    BoxTextSpan line;
+    for (int i = 1; i < box->height - 1; i++)
+    {
+        if (box_text_next_line(&cursor, &line))
+        { box_render_text_line(out, box->width, line.start, line.length); }
+        else
+        { render_box_line(out, box->width, BOX_V_LINE, " ", BOX_V_LINE); }
+    }
 
-    return 0;
+    // --------- Rendering last line ---------- //
+    if (draw_bottom) { box_render_bottom_line(out, box->width); }
+    return out->failed;
 }
 
 char** box_to_lines(Box* box)
@@ -130,365 +154,160 @@ char** box_to_lines(Box* box)
     // check for a NULL pointer
     if (!box) { return NULL; }
 
-    // invoke a helper function to generate an array of lines to print
-    char** lines = make_box_lines(box->width, box->height, box->title, box->text);
-    if (!lines) { return NULL; }
-    return lines;
-}
-
-
-// =========================== Helper Functions ============================ //
-// Helper function that takes in a width and height, and generates a series of
-// strings, each representing a single line in the box. The number of lines
-// returned is equal to the 'height' parameter. A title string is also taken
-// in - if it's not NULL, and the width of the box is long enough to print the
-// title, the title will be printed on the top line of the box.
-// If an error occurs, or allocation fails, NULL is returned.
-// NOTE: if the width or height is below the minimum value (box.h's
-// BOX_MIN_WIDTH/BOX_MIN_HEIGHT), NULL is returned.
-char** make_box_lines(uint16_t width, uint16_t height, char* title, char* text)
-{
-    // if width or height is zero, modify it
-    if (width < BOX_MIN_WIDTH || height < BOX_MIN_HEIGHT)
-    { return NULL; }
-
-    // allocate an array of strings to represent each line (the extra slot at
-    // the end will be NULL.
-    char** lines = calloc(height + 1, sizeof(char*));
-    /* calloc check */ if (!lines) { return NULL; }
-    lines[height] = NULL;
-    int line_width = width * BOX_CHARACTER_SIZE;
-    
-    // --------- Creating first line --------- //
-    // create the first line: it will have corners and horizontal lines
-    lines[0] = calloc(line_width + 
-                      (strlen(C_BOX) * 2) +
-                      (strlen(C_NONE) * 2) + 1,
-                      sizeof(char));
-    /* calloc check */ if (!lines[0])
-    /* calloc check */ { return free_string_array(lines, 0); }
-    // attempt to fill the top line with the title, if it's long enough. If it
-    // fails, fill the line as normal (without the title)
-    if (fill_box_line_with_title(&lines[0], width, BOX_TL_CORNER, BOX_H_LINE, BOX_TR_CORNER, title))
-    { fill_box_line(&lines[0], width, BOX_TL_CORNER, BOX_H_LINE, BOX_TR_CORNER); }
-
-    // -------- Creating middle lines -------- //
-    // attempt to split the box's text into lines. If it fails, free and return
-    int has_text = text != NULL;
-    char** text_lines = NULL;
-    char** current_text_line = NULL;
-    if (has_text)
+    // render the box, then split it into one string per line
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return NULL; }
+    if (box_render(box, out))
     {
-        text_lines = split_text_by_newline(text);
-        if (!text_lines) { return free_string_array(lines, 1); }
-        current_text_line = text_lines;
+        output_buffer_free(out);
+        return NULL;
     }
-    // iterate through indexes 1..(height - 2) and create middle strings
-    for (int i = 1; i < height - 1; i++)
+    char** lines = calloc(box->height + 1, sizeof(char*));
+    char* current = out->data;
+    for (int i = 0; lines && i < box->height; i++)
     {
-        lines[i] = calloc(line_width +
-                          (strlen(C_BOX) * 2) +
-                          (strlen(C_NONE) * 2) + 1,
-                          sizeof(char));
-        /* calloc check */ if (!lines[i])
-        /* calloc check */ { return free_string_array(lines, i); }
-
-        // if we have a line of text to use for this line, attempt to use it
-        int text_fill_failed = 1;
-        if (has_text && *current_text_line)
+        char* newline = strchr(current, '\n');
+        lines[i] = strndup(current, newline - current);
+        if (!lines[i])
         {
-            text_fill_failed = fill_box_line_with_text(&lines[i], width, BOX_V_LINE,
-                                                       " ", BOX_V_LINE, *(current_text_line++));
+            for (int j = 0; j < i; j++) { free(lines[j]); }
+            free(lines);
+            lines = NULL;
+            break;
         }
-        // if the text-fill failed, fill the line as normal
-        if (text_fill_failed)
-        { fill_box_line(&lines[i], width, BOX_V_LINE, " ", BOX_V_LINE); }
+        current = newline + 1;
     }
-    // free the text lines
-    if (has_text)
-    { free_string_array_null_terminated(text_lines); }
-
-    // --------- Creating last line ---------- //    
-    // create the last line: it will have corners and horizontal lines
-    lines[height - 1] = calloc(line_width +
-                               strlen(C_BOX) +
-                               strlen(C_NONE) + 1,
-                               sizeof(char));
-    /* calloc check */ if (!lines[height - 1])
-    /* calloc check */ { return free_string_array(lines, height - 1); }
-    fill_box_line(&lines[height - 1], width, BOX_BL_CORNER, BOX_H_LINE, BOX_BR_CORNER);
-
+    output_buffer_free(out);
     return lines;
 }
 
-// Helper function for 'make_box_lines' that's used to build a single line for
-// a box. The parameters are as follows:
-// - line:      The pointer to the string to be filled (must be calloc'd already)
-// - width:     The width of the box to be drawn
-// - left_edge: The box-drawing character/string for the left side of the box
-// - middle:    The middle character/string used to fill the middle of the line
-// - right_edge: The box-drawing character/string for the right side of the box
-// Upon completion, 'line' is filled appropriately.
-void fill_box_line(char** line, int width, char* left_edge,
-                   char* middle, char* right_edge)
-{
-    // compute lengths
-    int length = strlen(*line);
-    int left_length = strlen(left_edge);
-    int middle_length = strlen(middle);
-    int right_length = strlen(right_edge);
-
-    // write the left edge
-    memmove(*line + length, C_BOX, strlen(C_BOX));
-    length += strlen(C_BOX);
-    memmove(*line + length, left_edge, left_length);
-    length += left_length;
-
-    // write the middle characters
-    for (int i = 0; i < width - 2; i++)
-    {
-        memmove(*line + length, middle, middle_length);
-        length += middle_length;
-    }
 
-    // write the right edge
-    memmove(*line + length, right_edge, right_length);
-    length += right_length;
-    memmove(*line + length, C_NONE, strlen(C_NONE));
+// ============================ Text Line Spans ============================ //
+int box_text_next_line(char** cursor, BoxTextSpan* span)
+{
+    if (!cursor || !*cursor || !span) { return 0; }
+
+    // the line runs up to the next newline (or the end of the string). If
+    // there isn't another newline, this is the last line
+    char* newline = strchr(*cursor, '\n');
+    span->start = *cursor;
+    span->length = newline ? newline - *cursor : (int) strlen(*cursor);
+    *cursor = newline ? newline + 1 : NULL;
+    return 1;
 }
 
-// Helper function that works the same way as 'fill_box_line', but it attempts
-// to add a title to the left side of the line. If the width of the line isn't
-// long enough to fit the line, nothing is written and a non-zero value is
-// returned. Otherwise, 'line' is filled and 0 is returned.
-int fill_box_line_with_title(char** line, int width, char* left_edge,
-                             char* middle, char* right_edge, char* title)
+
+// ========================= Line-by-Line Rendering ======================== //
+void box_render_top_line(OutputBuffer* out, int width, char* top_left,
+                         char* top_right, char* title)
 {
-    // if the title is NULL, return 1
-    if (!title) { return 1; }
-
-    // check for the correct length - if the title length is longer than the
-    // available room, adjust the title length
-    int title_length = strlen(title);
-    int available_length = width - 6;
-    int has_runoff = title_length > available_length;
-    if (has_runoff) { title_length = available_length; }
-    
-    // create a local copy of the string and copy in the correct number
-    // of characters
-    char title_copy[title_length + 1];
-    memset(title_copy, 0, title_length + 1);
-    int title_copy_length = 0;
-    if (has_runoff)
+    if (title)
     {
-        int runoff_length = strlen(BOX_TEXT_RUNOFF);
-        // add a portion of the title
-        memmove(title_copy, title, title_length - runoff_length);
-        title_copy_length += title_length - runoff_length;
-        // add the runoff text
-        memmove(title_copy + title_copy_length, BOX_TEXT_RUNOFF, runoff_length);
-        title_copy_length += runoff_length;
+        render_box_line_with_title(out, width, top_left, BOX_H_LINE,
+                                   top_right, title);
     }
     else
-    {
-        memmove(title_copy, title, title_length);
-        title_copy_length += title_length;
-    }
-    
-    // otherwise, fill the string
-    int line_length = strlen(*line);
-    line_length += snprintf(*line, (strlen(C_BOX) * 2) + strlen(left_edge) +
-                            strlen(BOX_H_LINE) + strlen(C_NONE) + title_length + 3,
-                            C_BOX "%s%s" C_NONE " %s " C_BOX,
-                            left_edge, BOX_H_LINE, title_copy);
-    int current_length = title_length + 4;
-
-    // fill the remaining spots (except the last) with the middle string
-    int middle_length = strlen(middle);
-    for (int i = current_length; i < width - 1; i++)
-    {
-        memmove(*line + line_length, middle, middle_length);
-        line_length += middle_length;
-    }
-
-    // fill the final spot with the right edge string
-    memmove(*line + line_length, right_edge, strlen(right_edge));
-    memmove(*line + line_length + strlen(right_edge), C_NONE, strlen(C_NONE));
-
-    // success - return 0
-    return 0;
+    { render_box_line(out, width, top_left, BOX_H_LINE, top_right); }
 }
 
-// Helper function that works the same way as 'fill_box_line', but it attempts
-// to add left-justified text to the string. If the width of the line isn't
-// long enough to hold the entire text, as much text is written as possible.
-// On failure to write, a non-zero value is returned. On success, 0 is returned
-int fill_box_line_with_text(char** line, int width, char* left_edge,
-                             char* middle, char* right_edge, char* text)
+void box_render_text_line(OutputBuffer* out, int width, char* text, int length)
 {
-    // if the text is NULL, return 1
-    if (!text) { return 1; }
-
-    // count the number of extended unicode characters in the string
-    int text_length = strlen(text);
-    int text_colors_length = count_color_codes(text, text_length);
-    int unicode_count = count_string_extended_unicode(text, text_length);
-    // if extended unicode characters are present, we need to adjust the text
-    // length. Each extended character takes 3 bytes
-    if (unicode_count > 0)
-    {
-        width += 2 * unicode_count;
-        *line = realloc(*line, (width * BOX_CHARACTER_SIZE) +
-                               (strlen(C_BOX) * 2) +
-                               (strlen(C_NONE) * 2));
-    }
-
-    // determine how much room there is for the text
-    int runoff_length = strlen(BOX_TEXT_RUNOFF);
-    int available_length = (width - 2) - runoff_length + 1;
-    int copied_text_length = text_length;
-    if (text_length - text_colors_length > available_length)
-    { copied_text_length = available_length + text_colors_length; }
-
-    // make a local copy of the text of the appropriate length
-    char text_copy[copied_text_length + 1];
-    snprintf(text_copy, copied_text_length + 1, "%s", text);
-    // if we couldn't fit all the text, add the 'runoff indicator' to the end
-    if (text_length - text_colors_length > available_length)
-    {
-        snprintf(text_copy + strlen(text_copy) - runoff_length,
-                 runoff_length + 1, "%s", BOX_TEXT_RUNOFF);
-        //snprintf(text_copy + copied_text_length - runoff_length, runoff_length + 1,
-                 //"%s", BOX_TEXT_RUNOFF);
-    }
-
-    // write the left edge
-    int length = strlen(*line);
-    length += snprintf(*line + length,
-                       strlen(left_edge) + 2 + strlen(C_BOX) + strlen(C_NONE),
-                       C_BOX "%s " C_NONE, left_edge);
-
-    // write the middle characters
-    length += snprintf(*line + length, copied_text_length + 1, "%s", text_copy);
-    int middle_length = strlen(middle);
-    for (int i = 0; i < width - 4 - (copied_text_length - text_colors_length); i++)
-    { length += snprintf(*line + length, middle_length + 1, "%s", middle); }
-
-    // write the right edge
-    length += snprintf(*line + length,
-                       strlen(right_edge) + 2 + strlen(C_BOX) + strlen(C_NONE),
-                       C_BOX " %s" C_NONE, right_edge);
-
-    return 0;
+    BoxTextSpan line = {text, length};
+    render_box_line_with_text(out, width, BOX_V_LINE, " ", BOX_V_LINE, &line);
 }
 
-// Takes in a single string and attempts to split it into multiple strings
-// separated by "\n". Returns a dynamically-allocated array of dynamically-
-// allocated strings on success, and NULL on failure. The array returned
-// will be suffixed by a NULL entry, to indicate the end of the array.
-char** split_text_by_newline(char* text)
-{
-    // check for a NULL string
-    if (!text) { return NULL; }
-
-    // if the text is an empty string, return a char** containing a single
-    // empty string
-    if (strlen(text) == 0)
-    {
-        char** result = calloc(2, sizeof(char*));
-        *result = calloc(1, sizeof(char));
-        return result;
-    }
+void box_render_bottom_line(OutputBuffer* out, int width)
+{ render_box_line(out, width, BOX_BL_CORNER, BOX_H_LINE, BOX_BR_CORNER); }
 
-    // iterate through the string and count the number of "\n" occurrences
-    int text_length = strlen(text);
-    int line_count = 0;
-    for (int i = 0; i < text_length; i++)
-    { line_count += text[i] == '\n'; }
-    line_count++; // add one more to account for the last line
-    
-    // allocate an array of strings to hold each line
-    char** lines = calloc(line_count + 1, sizeof(char*));
-    /* calloc check */ if (!lines) { return NULL; }
-
-    // make a local copy of the text
-    char text_copy[text_length + 1];
-    snprintf(text_copy, text_length + 1, "%s", text);
-    // repeatedly find the occurrences of each "\n" and use it to copy each
-    // line into a new string
-    char* current = text_copy;
-    for (int i = 0; i < line_count; i++)
-    {
-        char* line = strtok(current, "\n");
 
-        // allocate a new string in the array
-        int line_length = strlen(line);
-        lines[i] = calloc(line_length + 1, sizeof(char));
-        /* calloc check */ if (!lines[0])
-        /* calloc check */ { return free_string_array(lines, i); }
-        snprintf(lines[i], line_length + 1, "%s", line);
-
-        // update the pointer to NULL for all future calls of strtok()
-        current = NULL;
-    }
-
-    return lines;
+// =========================== Helper Functions ============================ //
+// Helper function that's used to render a single line of a box. The
+// parameters are as follows:
+// - out:       The buffer to render the line into
+// - width:     The width of the box to be drawn
+// - left_edge: The box-drawing character/string for the left side of the box
+// - middle:    The middle character/string used to fill the middle of the line
+// - right_edge: The box-drawing character/string for the right side of the box
+void render_box_line(OutputBuffer* out, int width, char* left_edge,
+                     char* middle, char* right_edge)
+{
+    output_string(out, C_BOX);
+    output_string(out, left_edge);
+    output_repeat(out, middle, width - 2);
+    output_string(out, right_edge);
+    output_string(out, C_NONE "\n");
 }
 
-
-// Takes in a char** returned from and attempts to free each inner string and
-// the string array itself.
-void free_string_array_null_terminated(char** lines)
+// Helper function that works the same way as 'render_box_line', but it adds a
+// title to the left side of the line. If the title is too long to fit, it's
+// cut short (and ends with BOX_TEXT_RUNOFF).
+void render_box_line_with_title(OutputBuffer* out, int width, char* left_edge,
+                                char* middle, char* right_edge, char* title)
 {
-    // iterate until NULL is reached (there should be an extra slot at the end
-    // of the array that's been NULL'd out)
-    char** current = lines;
-    while (*current)
-    { free(*(current++)); }
-
-    // free the array pointer
-    free(lines);
+    // write the left edge and as much of the title as fits
+    output_string(out, C_BOX);
+    output_string(out, left_edge);
+    output_string(out, BOX_H_LINE C_NONE " ");
+    int title_columns = render_fitted_text(out, title, strlen(title), width - 6);
+    output_string(out, " " C_BOX);
+
+    // fill the remaining spots (except the last) with the middle string, then
+    // write the right edge
+    output_repeat(out, middle, width - 1 - (title_columns + 4));
+    output_string(out, right_edge);
+    output_string(out, C_NONE "\n");
 }
 
-
-// Takes in a char** and a length, and free 'length' inner string, and the
-// string array pointer itself. Returns NULL.
-char** free_string_array(char** lines, int length)
+// Helper function that works the same way as 'render_box_line', but it adds
+// a line of left-justified text to the line. If the width of the
+// line isn't long enough to hold the entire text, as much text is written as
+// possible, ending with BOX_TEXT_RUNOFF.
+void render_box_line_with_text(OutputBuffer* out, int width, char* left_edge,
+                               char* middle, char* right_edge, BoxTextSpan* text)
 {
-    // free each individual lines
-    for (int i = 0; i < length; i++)
-    { free(lines[i]); }
-    // free the array itself
-    free(lines);
-
-    // return NULL
-    return NULL;
+    // write the left edge, the text, and the padding after it
+    output_string(out, C_BOX);
+    output_string(out, left_edge);
+    output_string(out, " " C_NONE);
+    int text_columns = render_fitted_text(out, text->start, text->length,
+                                          width - 4);
+    output_repeat(out, middle, width - 4 - text_columns);
+
+    // write the right edge
+    output_string(out, C_BOX " ");
+    output_string(out, right_edge);
+    output_string(out, C_NONE "\n");
 }
 
-// Helper function that takes in a string and returns the number of extended
-// unicode characters found in the string.
-int count_string_extended_unicode(char* text, int text_length)
+// Helper function that writes as much of the given text (of 'length' bytes)
+// as fits in 'max_columns' columns on the terminal. If it doesn't all fit,
+// it's cut short and ends with BOX_TEXT_RUNOFF. Returns the number of columns
+// written.
+int render_fitted_text(OutputBuffer* out, char* text, int length,
+                       int max_columns)
 {
-    // check for a NULL pointer
-    if (!text) { return 0; }
-
-    // by looking at each character's integer value, we can tell if extended
-    // unicode character are being used by seeing negative integer values. We
-    // can identify an extended unicode character by seeing the following:
-    //      '-30 -X -Y'
-    // where -30 indicate the presence of an extended character.
-    char unicode_flag = (char) -30;
-    // count the number of extended unicode characters in the string
-    int unicode_count = 0;
-    for (int i = 0; i < text_length; i ++)
+    // if the whole thing fits, write it as-is
+    int columns = display_width(text, length);
+    if (columns <= max_columns)
     {
-        if (text[i] == unicode_flag && i < text_length - 2)
-        {
-            unicode_count += ((int) text[i + 1] < 0) &&
-                             ((int) text[i + 2] < 0);
-        }
+        output_append(out, text, length);
+        return columns;
+    }
+
+    // otherwise, write as much as fits alongside the runoff text (which is
+    // plain ASCII, so its length is also its width)
+    int runoff_length = strlen(BOX_TEXT_RUNOFF);
+    if (max_columns < runoff_length)
+    {
+        if (max_columns < 0) { max_columns = 0; }
+        output_append(out, BOX_TEXT_RUNOFF, max_columns);
+        return max_columns;
     }
-    
-    return unicode_count;
+    int copied_length = display_width_prefix(text, length,
+                                             max_columns - runoff_length,
+                                             &columns);
+    output_append(out, text, copied_length);
+    output_string(out, BOX_TEXT_RUNOFF);
+    return columns + runoff_length;
 }
 
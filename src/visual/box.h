@@ -10,6 +10,7 @@
 #include<stdlib.h>
 #include<stdio.h>
 #include<inttypes.h>
+#include "output.h"
 
 // ======================== Box-Drawing Characters ========================= //
 // Box-drawing character definitions
@@ -35,6 +36,23 @@
 // text-related constants
 #define BOX_TEXT_RUNOFF "..."
 
+// ============================ Text Line Spans ============================ //
+// A 'BoxTextSpan' points at a single line inside a box's text, without copying
+// it: the line is the 'length' bytes starting at 'start' (it isn't null-
+// terminated, since the rest of the text follows it).
+typedef struct _BoxTextSpan
+{
+    char* start;        // the first character of the line
+    int length;         // number of bytes in the line (not counting '\n')
+} BoxTextSpan;
+
+// Iterates over the lines of a null-terminated string. 'cursor' must point at
+// the string before the first call. Each call stores the next line in 'span',
+// moves the cursor past it, and returns 1. Once there are no lines left, 0 is
+// returned. (An empty string holds a single, empty line.)
+int box_text_next_line(char** cursor, BoxTextSpan* span);
+
+
 // ============================== Box Struct =============================== //
 // The 'box' struct defines a data structure representing a box to be drawn on
 // the terminal window.
@@ -74,6 +92,17 @@ void box_adjust_to_text(Box* box, int force_readjust);
 // title of the box (if it has one). Otherwise, the print may not look ideal.
 int box_print(Box* box);
 
+// Takes in a Box pointer and renders it into the given output buffer, one line
+// of the box per line of output. Returns 0 on success and a non-zero value on
+// error.
+int box_render(Box* box, OutputBuffer* out);
+
+// Works like 'box_render', but the box's top corners are drawn with the given
+// strings (so it can join up with a box drawn above it), and its bottom line
+// is only drawn if 'draw_bottom' is non-zero.
+int box_render_with_edges(Box* box, OutputBuffer* out, char* top_left,
+                          char* top_right, int draw_bottom);
+
 // Takes in a Box pointer and generates the lines needed to draw the box to the
 // terminal. A pointer to a dynamically-allocated array of dynamically-allocated
 // strings is returned. The number of dynamically-allocated strings in the
@@ -81,4 +110,21 @@ int box_print(Box* box);
 // terminated.
 char** box_to_lines(Box* box);
 
+
+// ========================= Line-by-Line Rendering ======================== //
+// These render a single line of a box at a time, for callers that produce a
+// box's text as they go (rather than collecting it all into a Box first).
+//
+// Renders a box's top line, 'width' characters wide, with the given corner
+// strings. If 'title' isn't NULL, it's written on the left side of the line.
+void box_render_top_line(OutputBuffer* out, int width, char* top_left,
+                         char* top_right, char* title);
+
+// Renders one line of text (the first 'length' bytes of 'text') inside a box
+// that's 'width' characters wide. Text that doesn't fit is cut short.
+void box_render_text_line(OutputBuffer* out, int width, char* text, int length);
+
+// Renders a box's bottom line, 'width' characters wide.
+void box_render_bottom_line(OutputBuffer* out, int width);
+
 #endif
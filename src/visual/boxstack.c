@@ -4,6 +4,7 @@
 
 // Module inclusions
 #include <string.h>
+#include <unistd.h>
 #include "boxstack.h"
 #include "colors.h"
 
@@ -70,6 +71,16 @@ void box_stack_set_width(BoxStack* stack, int box_width)
 }
 
 void box_stack_print(BoxStack* stack)
+{
+    // render every box into a buffer, then write it all out at once
+    OutputBuffer* out = output_buffer_new();
+    if (!out) { return; }
+    box_stack_render(stack, out);
+    output_buffer_flush(out, STDOUT_FILENO);
+    output_buffer_free(out);
+}
+
+void box_stack_render(BoxStack* stack, OutputBuffer* out)
 {
     // if we were given a NULL pointer, or the box's size is zero, return
     if (!stack || stack->size == 0) { return; }
@@ -77,34 +88,15 @@ void box_stack_print(BoxStack* stack)
     // iterate through each box
     for (int i = 0; i < stack->size; i++)
     {
-        Box* b = stack->boxes[i];
-        // retrieve an array of lines to print the current box
-        char** lines = box_to_lines(b);
-
-        // if this isn't the last box in the stack, we DON'T want to print the
-        // last line for this box. That line will be replaced by the top line
-        // of the *next* box.
-        int end = b->height;
-        if (i < stack->size - 1) { end--; }
-        // iterate through the lines and print
-        for (int j = 0; j < end; j++)
-        {
-            // if this is the top line of the box, AND it's not the first box,
-            // we want to modify the corner characters to visually connect the
-            // boxes.
-            if (i > 0 && j == 0)
-            {
-                memmove(lines[j], C_BOX, strlen(C_BOX));
-                memmove(lines[j] + strlen(C_BOX), BOX_L_CROSS, strlen(BOX_L_CROSS));
-                memmove(lines[j] + strlen(lines[j]) - (strlen(C_NONE) + strlen(BOX_TR_CORNER)),
-                        BOX_R_CROSS, strlen(BOX_R_CROSS));
-            }
-            fprintf(stdout, "%s\n", lines[j]);
-        }
-
-        // free the line strings
-        char** current = lines;
-        while (*current) { free(*(current++)); }
-        free (lines);
+        // if this isn't the first box in the stack, its top corners are
+        // drawn as crosses, to visually connect it to the box above. And if
+        // this isn't the last box in the stack, we DON'T want to draw its
+        // bottom line. That line will be replaced by the top line of the
+        // *next* box.
+        int is_first = i == 0;
+        box_render_with_edges(stack->boxes[i], out,
+                              is_first ? BOX_TL_CORNER : BOX_L_CROSS,
+                              is_first ? BOX_TR_CORNER : BOX_R_CROSS,
+                              i == stack->size - 1);
     }
 }
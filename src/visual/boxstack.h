@@ -39,4 +39,8 @@ void box_stack_set_width(BoxStack* stack, int box_width);
 // each other.
 void box_stack_print(BoxStack* stack);
 
+// Works like 'box_stack_print', but renders the stack into the given output
+// buffer instead of printing it.
+void box_stack_render(BoxStack* stack, OutputBuffer* out);
+
 #endif
@@ -48,11 +48,13 @@
 #define COLOR_MAX_LENGTH 64                     // max length of color code
 #define COLOR_NAME_MAX_LENGTH 64                // max length of color name
 
-// =============================== Prototypes =============================== //
-// Helper function that takes in a string and returns the number of bytes that
-// are taken up by color escape sequence strings.
-int count_color_codes(char* text, int text_length);
+// Palette indexes of the default colors (see the tables in colors.c). Tasks
+// and task lists store their color as one of these one-byte indexes, and only
+// look up the escape sequence when they're drawn.
+#define COLOR_INDEX_TASK_TITLE 4                // default task color
+#define COLOR_INDEX_BAR 5                       // default task list color
 
+// =============================== Prototypes =============================== //
 // Returns the number of available colors.
 int color_count(void);
 
@@ -68,4 +70,12 @@ const char* color_from_name(char* name);
 // Returns the color name, given the color code.
 const char* color_to_name(char* color);
 
+// Returns the index of the given color code, or -1 if it isn't found.
+int color_to_index(char* color);
+
+// Returns the palette index for a named color (matched the same way as
+// 'color_from_name'), or -1 if it isn't found. Colors that share an escape
+// sequence share an index: the first one in the palette.
+int color_index_from_name(char* name);
+
 #endif
@@ -0,0 +1,175 @@
+// A module that implements output.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+#include "output.h"
+
+// =============== Constants and Helper Function Prototypes ================ //
+int output_reserve(OutputBuffer* out, size_t length);
+
+
+// ========================== Output Buffer Struct ========================= //
+OutputBuffer* output_buffer_new()
+{
+    OutputBuffer* out = calloc(1, sizeof(OutputBuffer));
+    if (!out) { return NULL; }
+    out->data = malloc(OUTPUT_BUFFER_INITIAL_CAPACITY);
+    if (!out->data)
+    {
+        free(out);
+        return NULL;
+    }
+    out->data[0] = '\0';
+    out->capacity = OUTPUT_BUFFER_INITIAL_CAPACITY;
+    out->stream_fd = -1;
+    return out;
+}
+
+void output_buffer_free(OutputBuffer* out)
+{
+    if (!out) { return; }
+    free(out->data);
+    free(out);
+}
+
+char* output_buffer_detach(OutputBuffer* out)
+{
+    if (!out) { return NULL; }
+    char* result = out->failed ? NULL : out->data;
+    if (out->failed) { free(out->data); }
+    free(out);
+    return result;
+}
+
+void output_buffer_clear(OutputBuffer* out)
+{
+    if (!out) { return; }
+    out->length = 0;
+    out->data[0] = '\0';
+    out->failed = 0;
+}
+
+int output_buffer_flush(OutputBuffer* out, int fd)
+{
+    if (!out) { return 1; }
+    int failed = out->failed;
+
+    // anything printed through stdio has to come out first
+    fflush(stdout);
+
+    // write it all out (a single write, unless the kernel takes less)
+    size_t written = 0;
+    while (written < out->length)
+    {
+        ssize_t result = write(fd, out->data + written, out->length - written);
+        if (result < 0 && errno == EINTR) { continue; }
+        if (result <= 0)
+        {
+            failed = 1;
+            break;
+        }
+        written += result;
+    }
+
+    output_buffer_clear(out);
+    return failed;
+}
+
+void output_buffer_stream(OutputBuffer* out, int fd)
+{
+    if (out) { out->stream_fd = fd; }
+}
+
+int output_buffer_drain(OutputBuffer* out)
+{
+    if (!out) { return 1; }
+    if (out->stream_fd < 0 || out->length < OUTPUT_BUFFER_STREAM_THRESHOLD)
+    { return 0; }
+    return output_buffer_flush(out, out->stream_fd);
+}
+
+
+// =========================== Rendering Functions ========================= //
+void output_append(OutputBuffer* out, const char* data, size_t length)
+{
+    if (!out || !data || output_reserve(out, length)) { return; }
+    memcpy(out->data + out->length, data, length);
+    out->length += length;
+    out->data[out->length] = '\0';
+}
+
+void output_string(OutputBuffer* out, const char* string)
+{
+    if (string) { output_append(out, string, strlen(string)); }
+}
+
+void output_repeat(OutputBuffer* out, const char* string, int count)
+{
+    if (!out || !string || count <= 0) { return; }
+    size_t length = strlen(string);
+    if (output_reserve(out, length * count)) { return; }
+    for (int i = 0; i < count; i++)
+    {
+        memcpy(out->data + out->length, string, length);
+        out->length += length;
+    }
+    out->data[out->length] = '\0';
+}
+
+void output_printf(OutputBuffer* out, const char* format, ...)
+{
+    if (!out || !format) { return; }
+
+    // try formatting straight into the buffer. If it doesn't fit, grow the
+    // buffer and format it again
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(out->data + out->length,
+                           out->capacity - out->length, format, args);
+    va_end(args);
+    if (length < 0) { return; }
+    if ((size_t) length >= out->capacity - out->length)
+    {
+        if (output_reserve(out, length))
+        {
+            out->data[out->length] = '\0';
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(out->data + out->length, out->capacity - out->length,
+                  format, args);
+        va_end(args);
+    }
+    out->length += length;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Makes sure the buffer has room for another 'length' bytes (plus a null
+// terminator), doubling it as needed. Returns 0 on success and a non-zero
+// value on failure (which also marks the buffer as failed).
+int output_reserve(OutputBuffer* out, size_t length)
+{
+    if (out->failed) { return 1; }
+    size_t needed = out->length + length + 1;
+    if (needed <= out->capacity) { return 0; }
+
+    size_t capacity = out->capacity;
+    while (capacity < needed) { capacity *= 2; }
+    char* data = realloc(out->data, capacity);
+    if (!data)
+    {
+        out->failed = 1;
+        return 1;
+    }
+    out->data = data;
+    out->capacity = capacity;
+    return 0;
+}
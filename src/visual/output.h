@@ -0,0 +1,77 @@
+// This header file defines the OutputBuffer: a growable buffer that visual
+// components render into. Once something has been fully drawn, the buffer is
+// flushed to the terminal with a single write, rather than a printf for each
+// line (or character).
+//
+//      Connor Shugg
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+// Module inclusions
+#include <stddef.h>
+
+// ========================= Constants and Macros ========================== //
+#define OUTPUT_BUFFER_INITIAL_CAPACITY 4096 // bytes allocated up front
+#define OUTPUT_BUFFER_STREAM_THRESHOLD 65536 // bytes held before streaming
+
+
+// ========================== Output Buffer Struct ========================= //
+// The 'OutputBuffer' struct holds everything rendered since it was last
+// flushed. If it ever fails to grow, 'failed' is set and everything appended
+// after that is dropped (the error is reported when it's flushed).
+typedef struct _OutputBuffer
+{
+    char* data;             // the rendered bytes (always null-terminated)
+    size_t length;          // number of bytes in 'data'
+    size_t capacity;        // number of bytes allocated for 'data'
+    int failed;             // set if the buffer couldn't grow
+    int stream_fd;          // where to drain early to (-1 if nowhere)
+} OutputBuffer;
+
+// Constructor: dynamically allocates a new, empty OutputBuffer. If
+// allocation fails, NULL is returned.
+OutputBuffer* output_buffer_new();
+
+// Destructor: frees the buffer and everything in it.
+void output_buffer_free(OutputBuffer* out);
+
+// Takes the buffer's contents out of it and returns them as a dynamically-
+// allocated, null-terminated string (which the caller must free). The buffer
+// is freed. Returns NULL if anything failed to render.
+char* output_buffer_detach(OutputBuffer* out);
+
+// Empties the buffer, keeping its memory around to be reused.
+void output_buffer_clear(OutputBuffer* out);
+
+// Writes everything in the buffer to the given file descriptor (anything
+// waiting in stdio's stdout buffer is flushed first, so output stays in order)
+// and empties the buffer. Returns 0 on success and a non-zero value on failure.
+int output_buffer_flush(OutputBuffer* out, int fd);
+
+// Lets the buffer be written out to the given file descriptor before it's
+// flushed, whenever 'output_buffer_drain' finds it holding more than
+// OUTPUT_BUFFER_STREAM_THRESHOLD bytes. This keeps memory use bounded while
+// drawing something huge. (Pass -1 to turn it back off.)
+void output_buffer_stream(OutputBuffer* out, int fd);
+
+// If the buffer is being streamed and has grown past the threshold, writes
+// it out and empties it. Renderers producing a lot of output call this
+// between lines. Returns 0 on success and a non-zero value on failure.
+int output_buffer_drain(OutputBuffer* out);
+
+
+// =========================== Rendering Functions ========================= //
+// Appends 'length' bytes of the given data to the buffer.
+void output_append(OutputBuffer* out, const char* data, size_t length);
+
+// Appends a null-terminated string to the buffer.
+void output_string(OutputBuffer* out, const char* string);
+
+// Appends the given string to the buffer 'count' times.
+void output_repeat(OutputBuffer* out, const char* string, int count);
+
+// Appends a printf-formatted string to the buffer.
+void output_printf(OutputBuffer* out, const char* format, ...);
+
+#endif
@@ -2,28 +2,116 @@
 //
 //      Connor Shugg
 
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
 #include "terminal.h"
 
 // Helper function prototypes
-struct winsize get_window_size_info();
+void terminal_refresh_size();
+int terminal_size_from_environment(char* name, int fallback);
+void terminal_on_resize(int signal_number);
+
+// Cached terminal size (refreshed whenever it's marked stale)
+int terminal_width = 0;
+int terminal_height = 0;
+volatile sig_atomic_t terminal_size_stale = 1;
+volatile sig_atomic_t terminal_resized = 0;
+struct sigaction terminal_saved_resize_action;
+int terminal_watching_resize = 0;
 
 
 // ======================== Header Implementations ========================= //
 int get_terminal_width()
-{ return (int) get_window_size_info().ws_col; }
+{
+    if (terminal_size_stale) { terminal_refresh_size(); }
+    return terminal_width;
+}
 
 int get_terminal_height()
-{ return (int) get_window_size_info().ws_row; }
+{
+    if (terminal_size_stale) { terminal_refresh_size(); }
+    return terminal_height;
+}
+
+void terminal_forget_size()
+{ terminal_size_stale = 1; }
+
+int terminal_watch_resize(int watch)
+{
+    // if we're already doing what was asked, there's nothing to do
+    watch = watch != 0;
+    if (watch == terminal_watching_resize) { return 0; }
+
+    // stop watching by putting back whatever handled SIGWINCH before us
+    if (!watch)
+    {
+        terminal_watching_resize = 0;
+        return sigaction(SIGWINCH, &terminal_saved_resize_action, NULL);
+    }
+
+    // (SA_RESTART is left off, so a resize interrupts blocking reads)
+    struct sigaction action;
+    memset(&action, 0, sizeof(struct sigaction));
+    action.sa_handler = terminal_on_resize;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGWINCH, &action, &terminal_saved_resize_action))
+    { return 1; }
+    terminal_watching_resize = 1;
+    terminal_resized = 0;
+    return 0;
+}
+
+int terminal_was_resized()
+{
+    int resized = terminal_resized;
+    terminal_resized = 0;
+    return resized;
+}
 
 
 // =========================== Helper Functions ============================ //
-struct winsize get_window_size_info()
+// Looks up the terminal's size and caches it. The first of stdout, stderr and
+// stdin that's attached to a terminal is asked (so output piped into another
+// program is still drawn to fit the terminal it'll be viewed on). If none
+// are, the environment (or the defaults) are used instead.
+void terminal_refresh_size()
 {
-    struct winsize window;
-    if (ioctl(0, TIOCGWINSZ, &window) == -1)
+    terminal_size_stale = 0;
+    int fds[] = {STDOUT_FILENO, STDERR_FILENO, STDIN_FILENO};
+    for (int i = 0; i < 3; i++)
     {
-        window.ws_row = 0;
-        window.ws_col = 0;
+        struct winsize window;
+        if (ioctl(fds[i], TIOCGWINSZ, &window) == 0 && window.ws_col > 0)
+        {
+            terminal_width = window.ws_col;
+            terminal_height = window.ws_row;
+            return;
+        }
     }
-    return window;
+    terminal_width = terminal_size_from_environment("COLUMNS",
+                                                    TERMINAL_DEFAULT_WIDTH);
+    terminal_height = terminal_size_from_environment("LINES",
+                                                     TERMINAL_DEFAULT_HEIGHT);
+}
+
+// Reads a positive number from the given environment variable. If it isn't
+// set (or isn't a positive number), the fallback is returned.
+int terminal_size_from_environment(char* name, int fallback)
+{
+    char* value = getenv(name);
+    if (!value) { return fallback; }
+    char* end = NULL;
+    long size = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || size <= 0 || size > 0xFFFF)
+    { return fallback; }
+    return (int) size;
+}
+
+// Signal handler for SIGWINCH: the cached size is looked up again the next
+// time it's needed.
+void terminal_on_resize(int signal_number)
+{
+    terminal_size_stale = 1;
+    terminal_resized = 1;
 }
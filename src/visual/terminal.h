@@ -1,6 +1,11 @@
 // A small C header file defining functions used to retrieve terminal-related
 // information (such as the terminal size)
 //
+// The size is looked up once and cached for the rest of the process, so it
+// can be asked for as often as needed while drawing. Long-running modes (such
+// as the pager) can watch for SIGWINCH, which marks the cached size as stale
+// whenever the terminal is resized.
+//
 //      Connor Shugg
 
 // https://stackoverflow.com/questions/1022957/getting-terminal-width-in-c
@@ -12,10 +17,34 @@
 #include <stdio.h>
 #include <sys/ioctl.h>
 
+// ========================= Constants and Macros ========================== //
+// If none of stdout, stderr or stdin is a terminal (for example, when ttydo
+// is run from a script with its output piped elsewhere), the COLUMNS and
+// LINES environment variables are used. If those aren't set either, these
+// defaults are used
+#define TERMINAL_DEFAULT_WIDTH 80
+#define TERMINAL_DEFAULT_HEIGHT 24
+
+
+// ========================== Terminal Functions =========================== //
 // Retrieves the width of the terminal window, in characters.
 int get_terminal_width();
 
 // Retrieves the height of the terminal window, in characters.
 int get_terminal_height();
 
+// Marks the cached size as stale, so it's looked up again the next time it's
+// needed (for example, once stdout has been pointed at a different terminal).
+void terminal_forget_size();
+
+// Starts (if 'watch' is non-zero) or stops watching for the terminal being
+// resized. While watching, a resize refreshes the cached size, and
+// interrupts any blocking read (so the caller can redraw). Returns 0 on
+// success and a non-zero value on failure.
+int terminal_watch_resize(int watch);
+
+// Returns non-zero if the terminal has been resized since the last time this
+// was called (while watching for resizes).
+int terminal_was_resized();
+
 #endif
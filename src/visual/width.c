@@ -0,0 +1,238 @@
+// A module that implements width.h's definitions.
+//
+//      Connor Shugg
+
+// Module inclusions
+#include <stdlib.h>
+#include "width.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// =============== Constants and Helper Function Prototypes ================ //
+// A range of code points (inclusive on both ends)
+typedef struct _WidthRange
+{
+    uint32_t first;
+    uint32_t last;
+} WidthRange;
+
+// Combining marks, zero-width spaces/joiners, and variation selectors: these
+// are drawn on top of the character before them, so they take up no room
+static const WidthRange zero_width_ranges[] = {
+    {0x0300, 0x036F}, {0x0483, 0x0489}, {0x0591, 0x05BD}, {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2}, {0x05C4, 0x05C5}, {0x05C7, 0x05C7}, {0x0610, 0x061A},
+    {0x064B, 0x065F}, {0x0670, 0x0670}, {0x06D6, 0x06DC}, {0x06DF, 0x06E4},
+    {0x06E7, 0x06E8}, {0x06EA, 0x06ED}, {0x0900, 0x0902}, {0x093A, 0x093A},
+    {0x093C, 0x093C}, {0x0941, 0x0948}, {0x094D, 0x094D}, {0x0951, 0x0957},
+    {0x0E31, 0x0E31}, {0x0E34, 0x0E3A}, {0x0E47, 0x0E4E}, {0x1AB0, 0x1AFF},
+    {0x1DC0, 0x1DFF}, {0x200B, 0x200F}, {0x202A, 0x202E}, {0x2060, 0x2064},
+    {0x20D0, 0x20FF}, {0x302A, 0x302D}, {0x3099, 0x309A}, {0xFE00, 0xFE0F},
+    {0xFE20, 0xFE2F}, {0xFEFF, 0xFEFF}, {0x1F3FB, 0x1F3FF}, {0xE0001, 0xE0001},
+    {0xE0020, 0xE007F}, {0xE0100, 0xE01EF}
+};
+
+// East Asian wide and fullwidth characters, and emoji: these take up two
+// columns
+static const WidthRange wide_ranges[] = {
+    {0x1100, 0x115F}, {0x231A, 0x231B}, {0x2329, 0x232A}, {0x23E9, 0x23EC},
+    {0x23F0, 0x23F0}, {0x23F3, 0x23F3}, {0x25FD, 0x25FE}, {0x2614, 0x2615},
+    {0x2648, 0x2653}, {0x267F, 0x267F}, {0x2693, 0x2693}, {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB}, {0x26BD, 0x26BE}, {0x26C4, 0x26C5}, {0x26CE, 0x26CE},
+    {0x26D4, 0x26D4}, {0x26EA, 0x26EA}, {0x26F2, 0x26F3}, {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA}, {0x26FD, 0x26FD}, {0x2705, 0x2705}, {0x270A, 0x270B},
+    {0x2728, 0x2728}, {0x274C, 0x274C}, {0x274E, 0x274E}, {0x2753, 0x2755},
+    {0x2757, 0x2757}, {0x2795, 0x2797}, {0x27B0, 0x27B0}, {0x27BF, 0x27BF},
+    {0x2B1B, 0x2B1C}, {0x2B50, 0x2B50}, {0x2B55, 0x2B55}, {0x2E80, 0x303E},
+    {0x3041, 0x3247}, {0x3250, 0x4DBF}, {0x4E00, 0xA4CF}, {0xA960, 0xA97F},
+    {0xAC00, 0xD7A3}, {0xF900, 0xFAFF}, {0xFE10, 0xFE19}, {0xFE30, 0xFE6F},
+    {0xFF00, 0xFF60}, {0xFFE0, 0xFFE6}, {0x16FE0, 0x16FE4}, {0x17000, 0x18CFF},
+    {0x1B000, 0x1B2FF}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF},
+    {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F202},
+    {0x1F210, 0x1F23B}, {0x1F240, 0x1F248}, {0x1F250, 0x1F251},
+    {0x1F260, 0x1F265}, {0x1F300, 0x1F3FA}, {0x1F400, 0x1F64F},
+    {0x1F680, 0x1F6FF}, {0x1F7E0, 0x1F7EB}, {0x1F7F0, 0x1F7F0},
+    {0x1F90C, 0x1F9FF}, {0x1FA70, 0x1FAFF}, {0x20000, 0x2FFFD},
+    {0x30000, 0x3FFFD}
+};
+
+#define WIDTH_RANGE_COUNT(ranges) ((int) (sizeof(ranges) / sizeof(WidthRange)))
+
+int width_range_contains(const WidthRange* ranges, int count, uint32_t codepoint);
+int display_width_ascii_run(char* text, int length);
+int display_width_next(char* text, int length, int* columns);
+
+
+// ============================ Width Functions ============================ //
+int display_width_codepoint(uint32_t codepoint)
+{
+    // control characters take up no room, and nothing before the first
+    // combining mark is wide
+    if (codepoint < 0x20 || (codepoint >= 0x7F && codepoint < 0xA0))
+    { return 0; }
+    if (codepoint < 0x0300) { return 1; }
+
+    if (width_range_contains(zero_width_ranges,
+                             WIDTH_RANGE_COUNT(zero_width_ranges), codepoint))
+    { return 0; }
+    if (width_range_contains(wide_ranges, WIDTH_RANGE_COUNT(wide_ranges),
+                             codepoint))
+    { return 2; }
+    return 1;
+}
+
+int display_width(char* text, int length)
+{
+    if (!text) { return 0; }
+
+    int columns = 0;
+    int position = 0;
+    while (position < length)
+    {
+        // skip through plain ASCII as quickly as possible, then handle
+        // whatever stopped it
+        int run = display_width_ascii_run(text + position, length - position);
+        columns += run;
+        position += run;
+        if (position >= length) { break; }
+
+        int width = 0;
+        position += display_width_next(text + position, length - position,
+                                       &width);
+        columns += width;
+    }
+    return columns;
+}
+
+int display_width_prefix(char* text, int length, int max_columns, int* columns)
+{
+    if (max_columns < 0) { max_columns = 0; }
+
+    int used = 0;
+    int position = 0;
+    while (text && position < length)
+    {
+        // take as much plain ASCII as will fit
+        int run = display_width_ascii_run(text + position, length - position);
+        if (used + run > max_columns)
+        {
+            position += max_columns - used;
+            used = max_columns;
+            break;
+        }
+        used += run;
+        position += run;
+        if (position >= length) { break; }
+
+        // then the next character (or escape sequence), if it fits
+        int width = 0;
+        int size = display_width_next(text + position, length - position,
+                                      &width);
+        if (used + width > max_columns) { break; }
+        used += width;
+        position += size;
+    }
+
+    if (columns) { *columns = used; }
+    return position;
+}
+
+
+// =========================== Helper Functions ============================ //
+// Binary searches a sorted array of ranges for the given code point. Returns
+// non-zero if one of the ranges contains it.
+int width_range_contains(const WidthRange* ranges, int count, uint32_t codepoint)
+{
+    if (codepoint < ranges[0].first || codepoint > ranges[count - 1].last)
+    { return 0; }
+
+    int low = 0;
+    int high = count - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        if (codepoint < ranges[middle].first) { high = middle - 1; }
+        else if (codepoint > ranges[middle].last) { low = middle + 1; }
+        else { return 1; }
+    }
+    return 0;
+}
+
+// Returns the number of printable ASCII characters (each one column wide) at
+// the beginning of the text.
+int display_width_ascii_run(char* text, int length)
+{
+    int run = 0;
+#ifdef __SSE2__
+    // check 16 bytes at a time. Bytes with their high bit set (the start of
+    // any UTF-8 sequence) compare as negative, so a single signed comparison
+    // against a space catches them along with control characters (including
+    // the escape character)
+    __m128i space = _mm_set1_epi8(0x20);
+    __m128i delete = _mm_set1_epi8(0x7F);
+    while (run + 16 <= length)
+    {
+        __m128i bytes = _mm_loadu_si128((__m128i*) (text + run));
+        int special = _mm_movemask_epi8(_mm_or_si128(
+                          _mm_cmplt_epi8(bytes, space),
+                          _mm_cmpeq_epi8(bytes, delete)));
+        if (special) { return run + __builtin_ctz(special); }
+        run += 16;
+    }
+#endif
+    while (run < length && (unsigned char) text[run] >= 0x20 &&
+           (unsigned char) text[run] < 0x7F)
+    { run++; }
+    return run;
+}
+
+// Reads the character (or escape sequence) at the beginning of the text,
+// which is at least one byte long. Its width is saved to 'columns', and its
+// length in bytes is returned.
+int display_width_next(char* text, int length, int* columns)
+{
+    unsigned char byte = text[0];
+
+    // escape sequences take up no room. A control sequence ("ESC [") runs
+    // through any parameter bytes to its final byte. Any other escape is
+    // just two bytes long
+    if (byte == 0x1B)
+    {
+        *columns = 0;
+        if (length < 2) { return 1; }
+        if (text[1] != '[') { return 2; }
+        int size = 2;
+        while (size < length && (unsigned char) text[size] >= 0x20 &&
+               (unsigned char) text[size] <= 0x3F)
+        { size++; }
+        if (size < length && (unsigned char) text[size] >= 0x40 &&
+            (unsigned char) text[size] <= 0x7E)
+        { size++; }
+        return size;
+    }
+
+    // ASCII
+    if (byte < 0x80)
+    {
+        *columns = byte >= 0x20 && byte != 0x7F;
+        return 1;
+    }
+
+    // decode a UTF-8 sequence. A byte that doesn't start a valid one is
+    // drawn by the terminal as a single replacement character
+    int size = 0;
+    uint32_t codepoint = 0;
+    if ((byte & 0xE0) == 0xC0) { size = 2; codepoint = byte & 0x1F; }
+    else if ((byte & 0xF0) == 0xE0) { size = 3; codepoint = byte & 0x0F; }
+    else if ((byte & 0xF8) == 0xF0) { size = 4; codepoint = byte & 0x07; }
+    *columns = 1;
+    if (size == 0 || size > length) { return 1; }
+    for (int i = 1; i < size; i++)
+    {
+        unsigned char next = text[i];
+        if ((next & 0xC0) != 0x80) { return 1; }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    *columns = display_width_codepoint(codepoint);
+    return size;
+}
@@ -0,0 +1,30 @@
+// This header file defines functions that measure how many columns text takes
+// up on the terminal. Text is walked in a single pass: color (and other)
+// escape sequences take up no room, UTF-8 is decoded, and each character is
+// counted as zero, one, or two columns wide (CJK characters and most emoji
+// take up two).
+//
+//      Connor Shugg
+
+#ifndef WIDTH_H
+#define WIDTH_H
+
+// Module inclusions
+#include <inttypes.h>
+
+// ============================ Width Functions ============================ //
+// Returns the number of columns the given code point takes up on the
+// terminal: 0 (for control and combining characters), 1, or 2.
+int display_width_codepoint(uint32_t codepoint);
+
+// Returns the number of columns the first 'length' bytes of the given text
+// take up on the terminal.
+int display_width(char* text, int length);
+
+// Finds the longest beginning of the text (of 'length' bytes) that fits in
+// 'max_columns' columns, and returns its length in bytes. Characters are never
+// split, and escape sequences are never cut in half. The number of columns
+// the beginning takes up is saved to 'columns' (if it isn't NULL).
+int display_width_prefix(char* text, int length, int max_columns, int* columns);
+
+#endif
@@ -0,0 +1,41 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "../src/arena.h"
+#include "../src/task.h"
+
+int main()
+{
+    // allocate a few things and make sure they're aligned and zeroed
+    Arena* arena = arena_new(64);
+    char* a = arena_alloc(arena, 10);
+    char* b = arena_alloc(arena, 3);
+    printf("Aligned: %d %d, zeroed: %d\n", (uintptr_t) a % ARENA_ALIGNMENT == 0,
+           (uintptr_t) b % ARENA_ALIGNMENT == 0, a[0] == 0 && a[9] == 0);
+    printf("Distance between allocations: %ld\n", (long) (b - a));
+
+    // fill up the first block so more get added
+    for (int i = 0; i < 1000; i++) { arena_alloc(arena, 100); }
+    int blocks = 0;
+    for (ArenaBlock* block = arena->blocks; block; block = block->next)
+    { blocks++; }
+    printf("Blocks after 1000 allocations: %d\n", blocks);
+
+    // an allocation bigger than any block gets its own
+    char* big = arena_alloc(arena, 1 << 20);
+    printf("Big allocation: %d (block size %lu)\n", big != NULL,
+           (unsigned long) arena->blocks->size);
+
+    // tasks allocated from the arena can still be edited and freed (the
+    // strings they own are freed, but the tasks are left for the arena)
+    Task* task = task_new_in_arena("Arena task", "Allocated from an arena", arena);
+    printf("Task: '%s': '%s' (flags: %d)\n", task->title, task->description,
+           task->flags);
+    task_set_title(task, "Edited");
+    printf("Edited: '%s' (flags: %d)\n", task->title, task->flags);
+    task_free(task);
+
+    arena_free(arena);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/batch.h"
+
+// Splits a copy of the given line and prints each argument it was split into.
+void print_split(char* line)
+{
+    char copy[1024];
+    snprintf(copy, 1024, "%s", line);
+    char* args[BATCH_MAX_ARGS];
+    int argc = batch_split_line(copy, args, BATCH_MAX_ARGS);
+    for (char* c = line; *c; c++)
+    {
+        if (*c == '\t') { printf("\\t"); }
+        else if (*c == '\r') { printf("\\r"); }
+        else if (*c == '\n') { printf("\\n"); }
+        else { printf("%c", *c); }
+    }
+    printf(" --> %d:", argc);
+    for (int i = 0; i < argc; i++)
+    { printf(" [%s]", args[i]); }
+    printf("\n");
+}
+
+int main()
+{
+    // plain arguments, and runs of whitespace
+    print_split("task add work t1 d1");
+    print_split("  task\tadd   work  \r\n");
+    print_split("");
+
+    // quoted and escaped arguments
+    print_split("task add work \"Two words\" 'single quoted'");
+    print_split("task add work \"say \\\"hi\\\"\" 'a \\ b'");
+    print_split("task add work two\\ words \\#not-a-comment");
+    print_split("task add work \"\" ''");
+    print_split("task add work ab\"cd ef\"gh");
+    print_split("task add work \"it's\" 'say \"hi\"'");
+
+    // unterminated quotes
+    print_split("task add work \"no end");
+    print_split("task add work 'no end");
+
+    // comments (only at the start of an argument)
+    print_split("# only a comment");
+    print_split("   # an indented comment");
+    print_split("task add work t1 d1 # trailing comment");
+    print_split("task add work t#1 d1");
+
+    // a leading 'ttydo' is dropped (but not one anywhere else)
+    print_split("ttydo task mark work 3");
+    print_split("\"ttydo\" list");
+    print_split("ttydo");
+    print_split("task add work ttydo d1");
+
+    // exactly the most arguments a line may have, then one too many
+    char line[1024] = {'\0'};
+    for (int i = 0; i < BATCH_MAX_ARGS; i++)
+    { strcat(line, "a "); }
+    char copy[1024];
+    char* args[BATCH_MAX_ARGS];
+    snprintf(copy, 1024, "%s", line);
+    printf("%d arguments --> %d\n", BATCH_MAX_ARGS,
+           batch_split_line(copy, args, BATCH_MAX_ARGS));
+    strcat(line, "a");
+    snprintf(copy, 1024, "%s", line);
+    printf("%d arguments --> %d\n", BATCH_MAX_ARGS + 1,
+           batch_split_line(copy, args, BATCH_MAX_ARGS));
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/filebatch.h"
+
+// Prints each file as it's read, and counts them up.
+void print_file(int index, char* data, size_t length, struct stat* stats,
+                void* arg)
+{
+    (*((int*) arg))++;
+    printf("File %d: %lu bytes (stat says %ld): %.20s\n", index,
+           (unsigned long) length, (long) stats->st_size, data);
+    free(data);
+}
+
+int main()
+{
+    // write out a handful of files (one empty, one large)
+    int count = 100;
+    char* paths[count + 1];
+    for (int i = 0; i < count; i++)
+    {
+        paths[i] = malloc(64);
+        snprintf(paths[i], 64, "./filebatch_test_%d.txt", i);
+        FILE* file = fopen(paths[i], "w");
+        if (i == 1) { for (int j = 0; j < 100000; j++) { fputs("big ", file); } }
+        else if (i != 2) { fprintf(file, "contents of file %d", i); }
+        fclose(file);
+    }
+    // plus one that doesn't exist
+    paths[count] = "./filebatch_test_missing.txt";
+
+    // read them all back
+    int read_count = 0;
+    int result = file_batch_read(paths, count + 1, print_file, &read_count);
+    if (result)
+    { printf("io_uring isn't supported here; nothing was read.\n"); }
+    else
+    { printf("Read %d of %d files.\n", read_count, count + 1); }
+
+    // clean up
+    for (int i = 0; i < count; i++)
+    {
+        remove(paths[i]);
+        free(paths[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/hashindex.h"
+#include "../src/tasklist.h"
+
+int main()
+{
+    // add a bunch of values, some of them sharing a hash
+    HashIndex* index = hash_index_new();
+    int values[1000];
+    for (int i = 0; i < 1000; i++)
+    {
+        values[i] = i;
+        hash_index_add(index, hash_index_integer(i % 500), &values[i]);
+    }
+    printf("Index: %lu values in %lu slots\n", (unsigned long) index->count,
+           (unsigned long) index->capacity);
+
+    // look up a hash with two values, then remove one of them
+    size_t position = 0;
+    int* value;
+    printf("Values under hash(7):");
+    while ((value = hash_index_next(index, hash_index_integer(7), &position)))
+    { printf(" %d", *value); }
+    printf("\nRemoving 507: %d\n", hash_index_remove(index, hash_index_integer(7), &values[507]));
+    printf("Removing 507 again: %d\n", hash_index_remove(index, hash_index_integer(7), &values[507]));
+    position = 0;
+    printf("Values under hash(7):");
+    while ((value = hash_index_next(index, hash_index_integer(7), &position)))
+    { printf(" %d", *value); }
+    printf("\n");
+    hash_index_free(index);
+
+    // build a task list and search it by title and ID
+    TaskList* list = task_list_new("hash index test");
+    for (int i = 0; i < 2000; i++)
+    {
+        char title[32];
+        snprintf(title, 32, "Task %d", i);
+        Task* task = task_new(title, "description");
+        task->id = i;
+        task_list_append(list, task);
+    }
+    Task* task = task_list_get_by_title(list, "Task 1234");
+    printf("By title: '%s' (id: %lu)\n", task ? task->title : "(null)",
+           task ? task->id : 0);
+    task = task_list_get_by_id(list, 42);
+    printf("By ID: '%s'\n", task ? task->title : "(null)");
+
+    // rename, remove, and duplicate titles (the first one should be found)
+    task_list_set_task_title(list, task, "Renamed");
+    printf("Old title: %p, new title: '%s'\n", task_list_get_by_title(list, "Task 42"),
+           task_list_get_by_title(list, "Renamed")->title);
+    task_free(task_list_remove(list, task));
+    printf("After removing: %p %p\n", task_list_get_by_title(list, "Renamed"),
+           task_list_get_by_id(list, 42));
+    Task* duplicate = task_new("Task 7", "a duplicate");
+    task_list_insert(list, duplicate, 0);
+    printf("Duplicate title found first: %d\n",
+           task_list_get_by_title(list, "Task 7") == duplicate);
+
+    task_list_free(list);
+    return 0;
+}
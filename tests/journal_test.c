@@ -0,0 +1,74 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/journal.h"
+#include "../src/scribe.h"
+
+void print_list(TaskList* list)
+{
+    printf("List '%s' (%d tasks):\n", list->name, list->size);
+    for (int i = 0; i < list->size; i++)
+    {
+        Task* task = task_list_get_by_index(list, i);
+        printf(" %d. [%c] '%s': '%s'\n", i + 1, task->is_complete ? 'X' : ' ',
+               task->title, task->description);
+    }
+}
+
+int main()
+{
+    // create a list with a few tasks and save it in full
+    TaskList* list = task_list_new("journal test");
+    for (int i = 0; i < 3; i++)
+    {
+        char title[16];
+        snprintf(title, 16, "Task %d", i);
+        Task* task = task_new(title, "A task, with a comma.");
+        task->id = i + 1;
+        task_list_append(list, task);
+    }
+    printf("Save result: %d\n", save_task_list(list));
+
+    // make a series of changes, recording each one in the journal
+    Task* added = task_new("Added", "Added through the journal.");
+    added->id = 100;
+    task_list_append(list, added);
+    printf("Record 'add': %d\n", journal_record(list, JOURNAL_OP_ADD, added));
+
+    Task* task = task_list_get_by_index(list, 1);
+    task->is_complete = 1;
+    printf("Record 'complete': %d\n",
+           journal_record(list, JOURNAL_OP_COMPLETE, task));
+
+    free(task->title);
+    task->title = strdup("Renamed, with a comma");
+    printf("Record 'title': %d\n", journal_record(list, JOURNAL_OP_TITLE, task));
+
+    task_list_remove(list, added);
+    task_list_insert(list, added, 0);
+    printf("Record 'move': %d\n", journal_record(list, JOURNAL_OP_MOVE, added));
+
+    task = task_list_remove(list, task_list_get_by_index(list, 3));
+    printf("Record 'remove': %d\n", journal_record(list, JOURNAL_OP_REMOVE, task));
+    task_free(task);
+
+    printf("Journal size: %ld\n", (long) journal_file_size(list->name));
+    print_list(list);
+
+    // load the list back from disk - it should match the list in memory
+    TaskList* loaded = load_task_list(list->name);
+    if (loaded)
+    {
+        print_list(loaded);
+        task_list_free(loaded);
+    }
+
+    // save the list in full, which should delete the journal
+    printf("Save result: %d\n", save_task_list(list));
+    printf("Journal size: %ld\n", (long) journal_file_size(list->name));
+
+    // clean up
+    delete_task_list(list);
+    task_list_free(list);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/manifest.h"
+#include "../src/scribe.h"
+
+void print_entries(ManifestEntry* entries, int count)
+{
+    printf("Manifest entries: %d\n", count);
+    for (int i = 0; i < count; i++)
+    {
+        printf(" - '%s' (file: '%s') %d/%d completed, color '%s', %ld bytes\n",
+               entries[i].name, entries[i].file_name, entries[i].completed,
+               entries[i].size, entries[i].color, (long) entries[i].file_size);
+    }
+}
+
+void free_entries(ManifestEntry* entries, int count)
+{
+    for (int i = 0; i < count; i++)
+    { manifest_entry_free_fields(&entries[i]); }
+    if (entries) { free(entries); }
+}
+
+int main()
+{
+    // create and save a few task lists
+    int list_count = 3;
+    TaskList* lists[list_count];
+    for (int i = 0; i < list_count; i++)
+    {
+        char name[32];
+        snprintf(name, 32, "manifest test %d", i);
+        lists[i] = task_list_new(name);
+        for (int j = 0; j < i + 2; j++)
+        {
+            Task* task = task_new("Task", "A task, with a comma.");
+            task->is_complete = j % 2;
+            task_list_append(lists[i], task);
+        }
+        printf("Save result for '%s': %d\n", name, save_task_list(lists[i]));
+    }
+
+    // load the manifest - it should be built from scratch and include all of
+    // the lists we just saved
+    ManifestEntry* entries = NULL;
+    int count = manifest_load(&entries);
+    print_entries(entries, count);
+    free_entries(entries, count);
+
+    // load it again - this time everything should come from the manifest file
+    entries = NULL;
+    count = manifest_load(&entries);
+    print_entries(entries, count);
+    free_entries(entries, count);
+
+    // modify one of the lists on disk, then delete another. The manifest
+    // should notice both
+    Task* task = task_new("Another task", "Added after the manifest was built.");
+    task->is_complete = 1;
+    task_list_append(lists[0], task);
+    printf("Save result for '%s': %d\n", lists[0]->name, save_task_list(lists[0]));
+    printf("Delete result for '%s': %d\n", lists[1]->name,
+           delete_task_list(lists[1]));
+    entries = NULL;
+    count = manifest_load(&entries);
+    print_entries(entries, count);
+    free_entries(entries, count);
+
+    // clean up the remaining lists
+    delete_task_list(lists[0]);
+    delete_task_list(lists[2]);
+    for (int i = 0; i < list_count; i++)
+    { task_list_free(lists[i]); }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Measures the cost of loading a text task list: allocations and time per
+// task. malloc and friends are replaced below (glibc routes its own internal
+// allocations, such as strdup's and getline's, through them too) so every
+// allocation can be counted.
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "../src/scribe.h"
+#include "../src/visual/colors.h"
+
+// ========================== Allocation Counting ========================== //
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* pointer, size_t size);
+extern void __libc_free(void* pointer);
+static long allocations = 0;
+
+void* malloc(size_t size)
+{
+    allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    allocations++;
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer)
+{
+    __libc_free(pointer);
+}
+
+double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1000000000.0);
+}
+
+int main(int argc, char** argv)
+{
+    int task_count = 20000;
+    if (argc > 1) { task_count = atoi(argv[1]); }
+
+    // write a large list in the old (version 1) format, one comma-separated
+    // line per task, so loading it goes through the line parser. (Saving it
+    // would write the current format instead.) Every task has commas to
+    // unescape
+    TaskList* list = task_list_new("scribe bench");
+    char* path = make_task_list_file_path(list->name);
+    FILE* file = path ? fopen(path, "w") : NULL;
+    if (!file)
+    {
+        fprintf(stderr, "Couldn't write the benchmark list.\n");
+        return 1;
+    }
+    fprintf(file, "%s,%d,%s,%d\n", list->name, task_count,
+            color_name_from_index(COLOR_INDEX_BAR), (task_count + 2) / 3);
+    for (int i = 0; i < task_count; i++)
+    {
+        fprintf(file, "%d,%d,Task<COMMA> number %d,A description<COMMA> with "
+                "a couple of commas<COMMA> and enough text to look "
+                "realistic.,%s\n", i + 1, i % 3 == 0, i,
+                color_name_from_index(COLOR_INDEX_TASK_TITLE));
+    }
+    fclose(file);
+    free(path);
+
+    // parse a single line
+    char* line = "12345,1,A title<COMMA> with a comma,A description<COMMA> too,red";
+    long before = allocations;
+    Task* task = task_new_from_scribe_string(line);
+    printf("Single line: %ld allocations\n", allocations - before);
+    task_free(task);
+
+    // load the whole list back
+    before = allocations;
+    double start = now();
+    TaskList* loaded = load_task_list(list->name);
+    double elapsed = now() - start;
+    long count = allocations - before;
+    printf("Loaded %d tasks: %ld allocations (%.2f per task), %.2f ms "
+           "(%.3f us per task)\n", loaded ? loaded->size : 0, count,
+           (double) count / task_count, elapsed * 1000.0,
+           (elapsed * 1000000.0) / task_count);
+
+    // clean up
+    delete_task_list(list);
+    task_list_free(loaded);
+    task_list_free(list);
+    return 0;
+}
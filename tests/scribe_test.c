@@ -92,15 +92,15 @@ int main()
         { printf("Failed to insert task: '%s'\n", task_string); }
         if (task_string) { free(task_string); }
 
-        // attempt to get a scribe string
-        char* ss = task_get_scribe_string(task);
-        printf("Scribe Task String: '%s'\n", ss);
-        if (ss) { free(ss); }
+        // attempt to write a scribe record
+        char record[1024];
+        int record_length = task_write_scribe_record(task, record, 1024);
+        printf("Scribe Task Record (%d): '%s'\n", record_length, record);
     }
     
     // modify the first task to have a really long title and description
     // --------------------------------------------- //
-    Task* task0 = l1->head->task;
+    Task* task0 = l1->tasks[0];
     // title
     int new_title_length = TASK_TITLE_MAX_LENGTH + 8;
     task0->title = realloc(task0->title, new_title_length + 1);
@@ -113,10 +113,10 @@ int main()
     memset(task0->description, 0, new_desc_length + 1);
     for (int i = 0; i < new_desc_length; i++)
     { task0->description[i] = 'Y'; }
-    // generate a string for it to test the truncating
-    char* ss = task_get_scribe_string(task0);
-    printf("\nTruncated task string: '%s'\n", ss);
-    if (ss) { free(ss); }
+    // write a record for it to test the truncating
+    char record[1024];
+    int record_length = task_write_scribe_record(task0, record, 1024);
+    printf("\nTruncated task record (%d): '%s'\n", record_length, record);
     // --------------------------------------------- //
 
     // perform more tests with task-->string conversion
@@ -124,7 +124,12 @@ int main()
 
     // try creating a header string and converting back
     char* header = task_list_get_scribe_string(l1);
-    TaskList* from_header = task_list_new_from_scribe_string(header);
+    int header_size = 0;
+    int header_completed = 0;
+    TaskList* from_header = task_list_new_from_scribe_string(header, &header_size,
+                                                             &header_completed);
+    printf("Header: '%s' (size: %d, completed: %d)\n", header, header_size,
+           header_completed);
     
     if (header) { free(header); }
     if (from_header) { task_list_free(from_header); }
@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/taskbin.h"
+#include "../src/scribe.h"
+
+void print_list(TaskList* list)
+{
+    printf("List '%s' (%d tasks, format %d):\n", list->name, list->size,
+           list->format);
+    for (int i = 0; i < list->size; i++)
+    {
+        Task* task = task_list_get_by_index(list, i);
+        printf(" %d. [%c] '%s': '%s' (id: %lu, color: %s, flags: %d)\n", i + 1,
+               task->is_complete ? 'X' : ' ', task->title, task->description,
+               task->id, color_name_from_index(task->color), task->flags);
+    }
+}
+
+int main()
+{
+    // create a list with a few tasks
+    TaskList* list = task_list_new("taskbin test");
+    task_list_set_color(list, "green");
+    for (int i = 0; i < 4; i++)
+    {
+        char title[16];
+        snprintf(title, 16, "Task %d", i);
+        Task* task = task_new(title, "A task, with a comma.");
+        task->id = i + 1;
+        task->is_complete = i % 2;
+        if (i == 2) { task_set_color(task, "red"); }
+        task_list_append(list, task);
+    }
+    print_list(list);
+
+    // convert it to the binary format and back
+    size_t length = 0;
+    char* data = taskbin_from_task_list(list, &length);
+    printf("Binary length: %lu (is binary: %d)\n", (unsigned long) length,
+           taskbin_is_binary(data, length));
+    TaskList* converted = taskbin_to_task_list(data, length);
+    if (converted)
+    {
+        print_list(converted);
+
+        // edit a borrowed title (it should be copied, not modified in place)
+        Task* task = task_list_get_by_index(converted, 0);
+        task_set_title(task, "Edited");
+        printf("Edited title: '%s' (flags: %d)\n", task->title, task->flags);
+        task_list_free(converted);
+    }
+
+    // try converting some malformed data
+    printf("Truncated data: %p\n", taskbin_to_task_list(data, length - 1));
+    TaskBinRecord* records = (TaskBinRecord*) (data + sizeof(TaskBinHeader));
+    records[1].title_length = 0xFFFF;
+    printf("Bad record: %p\n", taskbin_to_task_list(data, length));
+    data[0] = 'X';
+    printf("Bad magic: %p\n", taskbin_to_task_list(data, length));
+    free(data);
+
+    // save it in the binary format, then load it back (which maps the file)
+    list->format = TASK_LIST_FORMAT_BINARY;
+    printf("Save result: %d\n", save_task_list(list));
+    TaskList* loaded = load_task_list(list->name);
+    if (loaded)
+    {
+        print_list(loaded);
+        task_list_free(loaded);
+    }
+
+    // clean up
+    delete_task_list(list);
+    task_list_free(list);
+    return 0;
+}
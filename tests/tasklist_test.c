@@ -16,13 +16,6 @@ void shuffle_int_array(int* array, int length)
 
 int main()
 {
-    // testing a single list element
-    Task* t1 = task_new("Task 1", "This is task 1!");
-    TaskListElem* e1 = task_list_elem_new(t1, NULL, NULL);
-    Task* e1_task = task_list_elem_free(e1);
-    printf("Task pointers equal? %p == %p\n\n", t1, e1_task);
-    task_free(t1);
-
     // testing a list
     TaskList* l1 = task_list_new("list 1");
     printf("Testing Task List: %s\n", l1->name);
@@ -78,8 +71,8 @@ int main()
     Task* task_insert1 = task_new("Inserted Task 1", "DESCRIPTION");
     int failed = task_list_insert(l1, task_insert1, 0);
     if (failed) { fprintf(stderr, "FAILED TO INSERT\n"); }
-    printf("-----\nAfter inserting at head:\nList head: %p\nList tail: %p\nList size: %d\n-----\n",
-           l1->head, l1->tail, l1->size);
+    printf("-----\nAfter inserting at head:\nList size: %d\nList capacity: %d\n-----\n",
+           l1->size, l1->capacity);
     stack1 = task_list_to_box_stack(l1, 1);
     box_stack_print(stack1);
     box_stack_free(stack1);
@@ -88,8 +81,8 @@ int main()
     Task* task_insert2 = task_new("Inserted Task 2", "DESCRIPTION");
     failed = task_list_insert(l1, task_insert2, l1->size);
     if (failed) { fprintf(stderr, "FAILED TO INSERT\n"); }
-    printf("-----\nAfter inserting at tail:\nList head: %p\nList tail: %p\nList size: %d\n-----\n",
-           l1->head, l1->tail, l1->size);
+    printf("-----\nAfter inserting at tail:\nList size: %d\nList capacity: %d\n-----\n",
+           l1->size, l1->capacity);
     stack1 = task_list_to_box_stack(l1, 1);
     box_stack_print(stack1);
     box_stack_free(stack1);
@@ -98,21 +91,16 @@ int main()
     Task* task_insert3 = task_new("Inserted Task 3", "DESCRIPTION");
     failed = task_list_insert(l1, task_insert3, 2);
     if (failed) { fprintf(stderr, "FAILED TO INSERT\n"); }
-    printf("-----\nAfter inserting in middle:\nList head: %p\nList tail: %p\nList size: %d\n-----\n",
-           l1->head, l1->tail, l1->size);
+    printf("-----\nAfter inserting in middle:\nList size: %d\nList capacity: %d\n-----\n",
+           l1->size, l1->capacity);
     stack1 = task_list_to_box_stack(l1, 1);
     box_stack_print(stack1);
     box_stack_free(stack1);
 
     // get an array of the tasks
     Task* task_array[l1->size];
-    TaskListElem* elem = l1->head;
-    int elem_index = 0;
-    while (elem_index < l1->size && elem)
-    {
-        task_array[elem_index++] = elem->task;
-        elem = elem->next;
-    }
+    for (int i = 0; i < l1->size; i++)
+    { task_array[i] = task_list_get_by_index(l1, i); }
 
     // create an array of integers from 0..(task_count - 1). Then, shuffle it
     int list_size = l1->size;
@@ -126,11 +114,11 @@ int main()
         int index = indexes[i];
         Task* result = task_list_remove(l1, task_array[index]);
         printf("Result of removing task: '%s' == '%s'", task_array[index]->title, result->title);
-        printf("\tList: [head = %p] [tail = %p] [size = %d]\n", l1->head, l1->tail, l1->size);
+        printf("\tList: [size = %d] [capacity = %d]\n", l1->size, l1->capacity);
         task_free(result);
     }
-    printf("-----\nAfter removing all elements:\nList head: %p\nList tail: %p\nList size: %d\n-----\n",
-           l1->head, l1->tail, l1->size);
+    printf("-----\nAfter removing all elements:\nList size: %d\nList capacity: %d\n-----\n",
+           l1->size, l1->capacity);
 
     // free the entire list
     task_list_free(l1);
@@ -0,0 +1,39 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "../src/visual/width.h"
+#include "../src/visual/colors.h"
+
+// Prints the display width of a string, along with its length in bytes.
+void print_width(char* text)
+{
+    printf("%3d columns, %3d bytes: %s" C_NONE "\n",
+           display_width(text, strlen(text)), (int) strlen(text), text);
+}
+
+int main()
+{
+    // plain ASCII (long enough to take the vectorized path), colors, and
+    // other escape sequences
+    print_width("Plain ASCII text that runs for more than sixteen bytes");
+    print_width(C_RED "red" C_NONE " and " C_BLUE "blue" C_NONE);
+    print_width("\033[1;4mbold, underlined\033[0m");
+
+    // box-drawing characters, accented letters, combining marks, CJK, emoji
+    print_width("┌──┐");
+    print_width("café vs café");
+    print_width("日本語テキスト");
+    print_width("emoji: \U0001F6D2 \U0001F95A ✅ ☕");
+
+    // cut text down to fit in a number of columns. Wide characters are
+    // never split, and escape sequences are never cut in half
+    char* text = C_GREEN "日本" C_NONE "abc";
+    for (int max = 0; max <= 8; max++)
+    {
+        int columns = 0;
+        int bytes = display_width_prefix(text, strlen(text), max, &columns);
+        printf("Fit in %d columns: %2d bytes, %d columns: '%.*s" C_NONE "'\n",
+               max, bytes, columns, bytes, text);
+    }
+    return 0;
+}